@@ -0,0 +1,60 @@
+/* Aabb.h */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+
+// Axis-aligned bounding box; default constructed empty so growing it by any
+// point or box yields that point or box
+struct Aabb {
+    glm::vec3 min{ 1e30f };
+    glm::vec3 max{ -1e30f };
+
+    Aabb() = default;
+    Aabb(const glm::vec3& bmin, const glm::vec3& bmax) : min(bmin), max(bmax) {}
+
+    void grow(const glm::vec3& p) { min = glm::min(min, p); max = glm::max(max, p); }
+    void grow(const Aabb& b) { min = glm::min(min, b.min); max = glm::max(max, b.max); }
+
+    bool empty() const { return min.x > max.x; }
+    glm::vec3 center() const { return (min + max) * 0.5f; }
+    glm::vec3 extent() const { return (max - min) * 0.5f; }
+
+    float surfaceArea() const
+    {
+        if (empty())
+            return 0.0f;
+        glm::vec3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    // Box around this one after an affine transform (Arvo)
+    Aabb transformed(const glm::mat4& m) const
+    {
+        glm::vec3 c = glm::vec3(m * glm::vec4(center(), 1.0f));
+        glm::vec3 e = extent();
+        glm::vec3 r(std::abs(m[0][0]) * e.x + std::abs(m[1][0]) * e.y + std::abs(m[2][0]) * e.z,
+                    std::abs(m[0][1]) * e.x + std::abs(m[1][1]) * e.y + std::abs(m[2][1]) * e.z,
+                    std::abs(m[0][2]) * e.x + std::abs(m[1][2]) * e.y + std::abs(m[2][2]) * e.z);
+        return Aabb(c - r, c + r);
+    }
+
+    bool intersectsSphere(const glm::vec3& center, float radius) const
+    {
+        glm::vec3 d = center - glm::clamp(center, min, max);
+        return glm::dot(d, d) <= radius * radius;
+    }
+
+    // Slab test; on a hit tNear is the entry distance (0 when starting inside)
+    bool intersectsRay(const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance, float& tNear) const
+    {
+        glm::vec3 t0 = (min - origin) * invDirection;
+        glm::vec3 t1 = (max - origin) * invDirection;
+        glm::vec3 tSmall = glm::min(t0, t1), tLarge = glm::max(t0, t1);
+        float enter = std::max(std::max(tSmall.x, tSmall.y), std::max(tSmall.z, 0.0f));
+        float exit = std::min(std::min(tLarge.x, tLarge.y), std::min(tLarge.z, maxDistance));
+        tNear = enter;
+        return enter <= exit;
+    }
+};
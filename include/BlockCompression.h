@@ -0,0 +1,23 @@
+/* BlockCompression.h */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Block-compressed texture formats produced by compressBlocks()
+enum class BlockFormat {
+    BC1,   // RGB, 4 bpp (S3TC DXT1)
+    BC3,   // RGBA, 8 bpp (S3TC DXT5)
+    BC5    // two channels (R, G), 8 bpp (RGTC2), for tangent-space normal maps
+};
+
+// Bytes per 4x4 block
+size_t blockBytes(BlockFormat format);
+// Bytes of a width x height image; partial edge blocks count as whole blocks
+size_t compressedSize(BlockFormat format, uint32_t width, uint32_t height);
+
+// Encode a tightly packed RGBA8 image into out (compressedSize bytes). Edge
+// blocks repeat the last row/column. Rows of blocks are spread over
+// threadCount threads; 0 uses every hardware thread.
+void compressBlocks(BlockFormat format, const uint8_t* rgba, uint32_t width, uint32_t height,
+                    uint8_t* out, unsigned int threadCount = 0);
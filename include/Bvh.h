@@ -0,0 +1,64 @@
+/* Bvh.h */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Aabb.h"
+#include "Frustum.h"
+#include "FrustumCulling.h"
+
+// Bounding volume hierarchy over object boxes
+// -------------------------------------------
+// Built top-down with binned surface area heuristic splits. When objects move,
+// refit() updates the boxes bottom-up without changing the topology; the SAH
+// cost then tells how far the tree has degraded from a fresh build, so callers
+// can rebuild only once it passes a threshold. Objects are identified by their
+// index in the bounds array given to build().
+class Bvh {
+public:
+    void build(const Aabb* bounds, size_t count);
+    // Same objects, new boxes
+    void refit(const Aabb* bounds);
+    void clear();
+
+    // Objects whose boxes touch the frustum. Subtrees fully inside skip all
+    // further plane tests; objects of leaves straddling a plane go through
+    // the SIMD box kernel together. Not safe to call concurrently.
+    void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& objects) const;
+    void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& objects) const;
+    // Nearest object box hit by the ray within maxDistance; false on a miss
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                 uint32_t& object, float& distance) const;
+
+    // Expected traversal cost relative to the root; lower is better
+    float sahCost() const { return m_cost; }
+    float builtCost() const { return m_builtCost; }
+    size_t objectCount() const { return m_objects.size(); }
+    size_t nodeCount() const { return m_nodes.size(); }
+
+private:
+    // Leaves own [first, first + count) of m_objects; inner nodes have
+    // count == 0 and their children at first and first + 1
+    struct Node {
+        Aabb     bounds;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    void split(uint32_t nodeIndex, std::vector<glm::vec3>& centroids);
+    float computeCost() const;
+
+    std::vector<Node>     m_nodes;
+    std::vector<uint32_t> m_objects;       // object ids in leaf order
+    std::vector<Aabb>     m_objectBounds;  // their boxes, in the same order
+    float                 m_cost = 0.0f;
+    float                 m_builtCost = 0.0f;
+
+    // Frustum query scratch: objects of straddling leaves, batched for cullAabbs
+    mutable AabbBoundsSoA         m_candidates;
+    mutable std::vector<uint32_t> m_candidateObjects;
+    mutable std::vector<uint32_t> m_candidateVisible;
+};
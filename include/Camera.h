@@ -5,6 +5,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "Frustum.h"
+
 // Defines several possible options for camera movement. Used as abstraction to stay away from window-system specific input methods
 enum Camera_Movement {
     FORWARD,
@@ -21,6 +23,8 @@ const float PITCH       =  0.0f;
 const float SPEED       =  2.5f;
 const float SENSITIVITY =  0.1f;
 const float ZOOM        =  45.0f;
+const float NEAR_PLANE  =  0.1f;
+const float FAR_PLANE   =  100.0f;
 
 
 // An abstract camera class that processes input and calculates the corresponding Euler Angles, Vectors and Matrices for use in OpenGL
@@ -41,6 +45,9 @@ public:
     float MovementSpeed;
     float MouseSensitivity;
     float Zoom;
+    // projection planes
+    float NearPlane = NEAR_PLANE;
+    float FarPlane  = FAR_PLANE;
 
     // constructor with vectors
     Camera(glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f), float yaw = YAW, float pitch = PITCH) : Front(glm::vec3(0.0f, 0.0f, -1.0f)), MovementSpeed(SPEED), MouseSensitivity(SENSITIVITY), Zoom(ZOOM)
@@ -62,11 +69,23 @@ public:
     }
 
     // returns the view matrix calculated using Euler Angles and the LookAt Matrix
-    glm::mat4 GetViewMatrix()
+    glm::mat4 GetViewMatrix() const
     {
         return glm::lookAt(Position, Position + Front, Up);
     }
 
+    // returns the perspective projection for the current zoom and clip planes
+    glm::mat4 GetProjectionMatrix(float aspect) const
+    {
+        return glm::perspective(glm::radians(Zoom), aspect, NearPlane, FarPlane);
+    }
+
+    // returns the world-space planes of the current view and projection
+    Frustum GetFrustum(float aspect) const
+    {
+        return Frustum::fromMatrix(GetProjectionMatrix(aspect) * GetViewMatrix());
+    }
+
     // processes input received from any keyboard-like input system. Accepts input parameter in the form of camera defined ENUM (to abstract it from windowing systems)
     void ProcessKeyboard(Camera_Movement direction, float deltaTime)
     {
@@ -0,0 +1,84 @@
+/* ClusteredLighting.h */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "Camera.h"
+#include "LightingManager.h"
+#include "Shader.h"
+#include "ShaderBuffer.h"
+
+// Froxel grid resolution: screen tiles in x/y, exponential depth slices in z
+struct ClusterGridDesc {
+    unsigned int tilesX{ 16 };
+    unsigned int tilesY{ 9 };
+    unsigned int slicesZ{ 24 };
+};
+
+// GPU-side grid parameters, mirrors the std140 "Clusters" block in lit_geometry.fs
+struct ClustersBlockStd140 {
+    glm::uvec4 grid;     // tilesX, tilesY, slicesZ, unused
+    glm::vec4  params;   // depth slice scale, depth slice bias, viewport width, viewport height
+};
+
+static_assert(sizeof(ClustersBlockStd140) == 32, "Clusters block must match std140 layout");
+
+// Clustered forward lighting
+// --------------------------
+// Splits the camera frustum into a 3D grid of froxels and assigns every point
+// light to the froxels its influence sphere touches. The fragment shader finds
+// its froxel from gl_FragCoord and view depth and only shades those lights.
+class ClusteredLighting {
+public:
+    // Binding points; must match lit_geometry.fs
+    static const unsigned int CLUSTERS_BINDING = 2;          // uniform block
+    static const unsigned int CELLS_SSBO_BINDING = 2;
+    static const unsigned int INDICES_SSBO_BINDING = 3;
+    static const unsigned int CELLS_TEXTURE_UNIT = 14;
+    static const unsigned int INDICES_TEXTURE_UNIT = 13;
+
+    // Requires a current GL context; use the same backend as the LightingManager
+    explicit ClusteredLighting(StorageBackend backend, const ClusterGridDesc& grid = ClusterGridDesc());
+
+    // Point a shader's cluster inputs at the shared buffers; call once per shader
+    void bindToShader(const Shader& shader) const;
+    // Assign the manager's point lights to froxels for this view and upload the lists
+    void update(const Camera& camera, int viewportWidth, int viewportHeight, const LightingManager& lighting);
+    // Free GPU resources; call before the GL context is destroyed
+    void release();
+
+    // Total light references across all froxels in the last update
+    size_t lightReferenceCount() const { return m_lightIndices.size(); }
+
+private:
+    struct ClusterBounds {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    void rebuildBounds(float fovY, float aspect, float zNear, float zFar);
+    unsigned int sliceForDepth(float depth) const;
+
+    ClusterGridDesc m_grid;
+
+    // Froxel AABBs in view space; only rebuilt when the projection changes
+    std::vector<ClusterBounds> m_bounds;
+    glm::vec4                  m_projectionKey{ 0.0f };
+    float                      m_sliceScale = 0.0f;
+    float                      m_sliceBias = 0.0f;
+    float                      m_tanHalfFovY = 0.0f;
+    float                      m_aspect = 1.0f;
+
+    // Per-frame assignment: (offset, count) per froxel into one flat index list
+    std::vector<glm::uvec2>    m_cells;
+    std::vector<uint32_t>      m_lightIndices;
+    std::vector<uint32_t>      m_pairCluster;
+    std::vector<uint32_t>      m_pairLight;
+
+    ClustersBlockStd140 m_block{};
+    unsigned int        m_ubo = 0;
+    ShaderBuffer        m_cellStorage;
+    ShaderBuffer        m_indexStorage;
+};
@@ -0,0 +1,78 @@
+/* CookedTexture.h */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+// Cooked texture container (.tex)
+// -------------------------------
+// Written by the texture-cooker tool. Holds every mip level already in its
+// final GL format so loading is a map plus one glTexImage2D per level. The
+// header records the options it was cooked with and a hash of the source
+// image, so a loader can tell when the file does not match a request:
+//
+//   CookedTextureHeader | CookedLevelDesc[levelCount] | level data (16-byte aligned)
+struct CookedTextureHeader {
+    static const uint32_t MAGIC = 0x5452474Fu;   // "OGRT"
+    static const uint32_t VERSION = 2;
+    static const uint32_t FLAG_COMPRESSED = 1u << 0;
+    static const uint32_t FLAG_SRGB = 1u << 1;
+    // Cook options, mirroring TextureOptions
+    static const uint32_t OPTION_SRGB = 1u << 0;
+    static const uint32_t OPTION_FLIP = 1u << 1;
+    static const uint32_t OPTION_NORMAL_MAP = 1u << 2;
+    static const uint32_t OPTION_COMPRESS = 1u << 3;
+    static const uint32_t OPTION_KAISER = 1u << 4;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    uint32_t internalFormat;   // GL internal format
+    uint32_t format;           // GL pixel format; 0 when compressed
+    uint32_t type;             // GL pixel type; 0 when compressed
+    uint32_t flags;
+    uint32_t options;          // OPTION_* the file was cooked with
+    uint64_t sourceHash;       // hashFile() of the source image
+};
+
+struct CookedLevelDesc {
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset;   // from the start of the file
+    uint64_t size;
+};
+
+static_assert(sizeof(CookedTextureHeader) == 48, "CookedTextureHeader layout is part of the file format");
+static_assert(sizeof(CookedLevelDesc) == 24, "CookedLevelDesc layout is part of the file format");
+
+// One mip level to be written
+struct CookedLevel {
+    uint32_t             width;
+    uint32_t             height;
+    std::vector<uint8_t> data;
+};
+
+// Write a container; offsets and sizes in the header are filled in here
+bool writeCookedTexture(const std::string& path, CookedTextureHeader header, const std::vector<CookedLevel>& levels);
+
+// Read-only view of a mapped container; level data points into the mapping
+class CookedTexture {
+public:
+    // Map and validate a container
+    bool open(const std::string& path);
+
+    const CookedTextureHeader& header() const { return *m_header; }
+    const CookedLevelDesc& level(uint32_t index) const { return m_levels[index]; }
+    const uint8_t* levelData(uint32_t index) const { return m_file.data() + m_levels[index].offset; }
+    bool compressed() const { return (m_header->flags & CookedTextureHeader::FLAG_COMPRESSED) != 0; }
+
+private:
+    MappedFile                 m_file;
+    const CookedTextureHeader* m_header = nullptr;
+    const CookedLevelDesc*     m_levels = nullptr;
+};
@@ -0,0 +1,11 @@
+/* CpuFeatures.h */
+#pragma once
+
+// Runtime CPU feature checks
+// --------------------------
+// The default build targets baseline x86-64 (SSE2). Wider kernels live in
+// their own translation units compiled with the extra instruction set and
+// are only called when the running CPU, and the OS, support it.
+
+// AVX instructions and OS-saved YMM state; false off x86
+bool cpuSupportsAvx();
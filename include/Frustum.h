@@ -0,0 +1,103 @@
+/* Frustum.h */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+
+// View frustum as six inward-facing planes (xyz = unit normal, w = distance)
+// --------------------------------------------------------------------------
+struct Frustum {
+    enum Plane { PLANE_LEFT, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR, PLANE_COUNT };
+
+    glm::vec4 planes[PLANE_COUNT];
+
+    // Extract the planes of a projection * view matrix (Gribb/Hartmann)
+    static Frustum fromMatrix(const glm::mat4& viewProjection)
+    {
+        const glm::mat4& m = viewProjection;
+        glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+        Frustum f;
+        f.planes[PLANE_LEFT]   = row3 + row0;
+        f.planes[PLANE_RIGHT]  = row3 - row0;
+        f.planes[PLANE_BOTTOM] = row3 + row1;
+        f.planes[PLANE_TOP]    = row3 - row1;
+        f.planes[PLANE_NEAR]   = row3 + row2;
+        f.planes[PLANE_FAR]    = row3 - row2;
+        for (glm::vec4& p : f.planes)
+            p /= glm::length(glm::vec3(p));
+        return f;
+    }
+
+    // The same planes expressed in the space a transform maps from, so
+    // model-space bounds can be tested without transforming them
+    Frustum transformed(const glm::mat4& transform) const
+    {
+        Frustum f;
+        glm::mat4 t = glm::transpose(transform);
+        for (int i = 0; i < PLANE_COUNT; ++i) {
+            f.planes[i] = t * planes[i];
+            f.planes[i] /= glm::length(glm::vec3(f.planes[i]));
+        }
+        return f;
+    }
+
+    bool intersectsSphere(const glm::vec3& center, float radius) const
+    {
+        for (const glm::vec4& p : planes) {
+            if (glm::dot(glm::vec3(p), center) + p.w < -radius)
+                return false;
+        }
+        return true;
+    }
+
+    // Box given by center and half extent, tested against the planes still set
+    // in mask; planes the box is fully inside of are cleared from mask so
+    // hierarchical callers can skip them for everything the box contains
+    enum Side { SIDE_OUTSIDE, SIDE_INSIDE, SIDE_STRADDLING };
+    Side classifyBox(const glm::vec3& center, const glm::vec3& extent, unsigned int& mask) const
+    {
+        for (int i = 0; i < PLANE_COUNT; ++i) {
+            if (!(mask & (1u << i)))
+                continue;
+            const glm::vec4& p = planes[i];
+            float d = p.x * center.x + p.y * center.y + p.z * center.z + p.w;
+            float reach = std::abs(p.x) * extent.x + std::abs(p.y) * extent.y + std::abs(p.z) * extent.z;
+            if (d + reach < 0.0f)
+                return SIDE_OUTSIDE;
+            if (d - reach >= 0.0f)
+                mask &= ~(1u << i);
+        }
+        return mask == 0 ? SIDE_INSIDE : SIDE_STRADDLING;
+    }
+
+    // Cone from apex along unit direction, with the given height and half angle cosine.
+    // Rejected when, for some plane, both the apex and the base disc lie outside.
+    bool intersectsCone(const glm::vec3& apex, const glm::vec3& direction, float height, float cosHalfAngle) const
+    {
+        // Wide cones are bounded more tightly by their sphere
+        if (cosHalfAngle <= 0.0f)
+            return intersectsSphere(apex, height);
+
+        float sinHalfAngle = std::sqrt(std::max(0.0f, 1.0f - cosHalfAngle * cosHalfAngle));
+        float baseRadius = height * sinHalfAngle / cosHalfAngle;
+        glm::vec3 baseCenter = apex + direction * height;
+
+        for (const glm::vec4& p : planes) {
+            glm::vec3 n(p);
+            if (glm::dot(n, apex) + p.w >= 0.0f)
+                continue;
+            // Point of the base disc furthest along the plane normal
+            glm::vec3 toward = n - direction * glm::dot(n, direction);
+            float len = glm::length(toward);
+            glm::vec3 extreme = len > 1e-6f ? baseCenter + toward * (baseRadius / len) : baseCenter;
+            if (glm::dot(n, extreme) + p.w < 0.0f)
+                return false;
+        }
+        return true;
+    }
+};
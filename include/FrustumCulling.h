@@ -0,0 +1,47 @@
+/* FrustumCulling.h */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Frustum.h"
+
+// Structure-of-arrays bounds: one SIMD lane per object, so the kernels test
+// four (SSE) or eight (AVX) objects per plane per iteration
+struct SphereBoundsSoA {
+    std::vector<float> x, y, z, radius;
+
+    void push(const glm::vec3& center, float r)
+    {
+        x.push_back(center.x); y.push_back(center.y); z.push_back(center.z);
+        radius.push_back(r);
+    }
+    void clear() { x.clear(); y.clear(); z.clear(); radius.clear(); }
+    size_t size() const { return radius.size(); }
+};
+
+// Boxes as center and half extent, which makes the plane test one dot product
+struct AabbBoundsSoA {
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> extentX, extentY, extentZ;
+
+    void push(const glm::vec3& bmin, const glm::vec3& bmax)
+    {
+        glm::vec3 c = (bmin + bmax) * 0.5f, e = (bmax - bmin) * 0.5f;
+        centerX.push_back(c.x); centerY.push_back(c.y); centerZ.push_back(c.z);
+        extentX.push_back(e.x); extentY.push_back(e.y); extentZ.push_back(e.z);
+    }
+    void clear()
+    {
+        centerX.clear(); centerY.clear(); centerZ.clear();
+        extentX.clear(); extentY.clear(); extentZ.clear();
+    }
+    size_t size() const { return centerX.size(); }
+};
+
+// Replace visible with the indices of the objects that intersect the
+// frustum, in ascending order; returns their count
+size_t cullSpheres(const Frustum& frustum, const SphereBoundsSoA& spheres, std::vector<uint32_t>& visible);
+size_t cullAabbs(const Frustum& frustum, const AabbBoundsSoA& boxes, std::vector<uint32_t>& visible);
@@ -0,0 +1,19 @@
+/* FrustumCullingAvx.h */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 8-wide AVX kernels behind cullSpheres/cullAabbs
+// -----------------------------------------------
+// Built in their own translation unit with AVX enabled; only call them when
+// cpuSupportsAvx(). They take raw arrays so no inline code from shared
+// headers is compiled with AVX. planes holds planeCount xyzw planes.
+// Each tests objects [0, count & ~7), appends the visible indices to out,
+// sets processed to the number of objects tested and returns how many it
+// appended. A build without AVX tests nothing.
+size_t cullSpheresAvx(const float* planes, int planeCount, const float* x, const float* y, const float* z,
+                      const float* radius, size_t count, uint32_t* out, size_t& processed);
+size_t cullAabbsAvx(const float* planes, int planeCount, const float* centerX, const float* centerY,
+                    const float* centerZ, const float* extentX, const float* extentY, const float* extentZ,
+                    size_t count, uint32_t* out, size_t& processed);
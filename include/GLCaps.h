@@ -0,0 +1,54 @@
+/* GLCaps.h */
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <unordered_set>
+
+// Enums for features above the GL 3.3 core profile glad was generated for.
+// They are only used after GLCaps confirms the context supports them.
+// --------------------------------------------------------------------------
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_MAX_SHADER_STORAGE_BLOCK_SIZE
+#define GL_MAX_SHADER_STORAGE_BLOCK_SIZE 0x90DE
+#endif
+// EXT_texture_compression_s3tc and its sRGB variants (EXT_texture_sRGB)
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+// Capabilities of the current GL context, queried once on first use
+// ------------------------------------------------------------------
+class GLCaps {
+public:
+    // Requires a current context
+    static const GLCaps& get();
+
+    bool hasVersion(int major, int minor) const;
+    bool hasExtension(const std::string& name) const;
+    // Whether glCompressedTexImage2D accepts this block-compressed internal format
+    bool supportsCompressedFormat(GLenum internalFormat) const;
+
+    int  major = 3;
+    int  minor = 3;
+    bool shaderStorageBuffers = false;   // SSBOs plus GLSL 4.30 (core in 4.3)
+    bool textureCompressionS3TC = false; // BC1/BC3
+    bool textureCompressionS3TCsRGB = false;
+    bool textureCompressionRGTC = false; // BC4/BC5 (core in 3.0)
+    // Largest texture buffer in texels (GL 3.3 guarantees 65536) and largest
+    // shader storage block in bytes (0 without SSBOs)
+    GLint   maxTextureBufferSize = 65536;
+    GLint64 maxShaderStorageBlockSize = 0;
+
+private:
+    GLCaps();
+
+    std::unordered_set<std::string> m_extensions;
+};
@@ -0,0 +1,85 @@
+/* HandleTable.h */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Stable reference into a densely packed array. The generation is bumped each
+// time a slot is freed so stale handles are detected instead of aliasing.
+struct Handle {
+    static const uint32_t INVALID = 0xFFFFFFFFu;
+
+    uint32_t slot{ INVALID };
+    uint32_t generation{ 0 };
+
+    bool isNull() const { return slot == INVALID; }
+};
+
+// Maps stable handles to indices of a dense array that is kept hole-free by
+// swap-and-pop removal. The table only tracks indices; the owner moves data.
+// -----------------------------------------------------------------------------
+class HandleTable {
+public:
+    // Register a new element that was appended at the end of the dense array
+    Handle create()
+    {
+        uint32_t slot;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        else {
+            slot = (uint32_t)m_slots.size();
+            m_slots.push_back({});
+        }
+        m_slots[slot].dense = (uint32_t)m_denseToSlot.size();
+        m_denseToSlot.push_back(slot);
+        return Handle{ slot, m_slots[slot].generation };
+    }
+
+    bool contains(Handle h) const
+    {
+        return h.slot < m_slots.size()
+            && m_slots[h.slot].generation == h.generation
+            && m_slots[h.slot].dense != Handle::INVALID;
+    }
+
+    // Dense index of a live handle
+    uint32_t indexOf(Handle h) const { return m_slots[h.slot].dense; }
+
+    // Handle of the element currently stored at a dense index
+    Handle handleAt(uint32_t index) const
+    {
+        uint32_t slot = m_denseToSlot[index];
+        return Handle{ slot, m_slots[slot].generation };
+    }
+
+    // Release a live handle. The owner must move its last element into the
+    // returned index and pop the back of every dense array.
+    uint32_t destroy(Handle h)
+    {
+        uint32_t index = m_slots[h.slot].dense;
+        uint32_t last = (uint32_t)m_denseToSlot.size() - 1;
+        uint32_t movedSlot = m_denseToSlot[last];
+        m_denseToSlot[index] = movedSlot;
+        m_slots[movedSlot].dense = index;
+        m_denseToSlot.pop_back();
+
+        m_slots[h.slot].dense = Handle::INVALID;
+        ++m_slots[h.slot].generation;
+        m_freeSlots.push_back(h.slot);
+        return index;
+    }
+
+    uint32_t size() const { return (uint32_t)m_denseToSlot.size(); }
+
+private:
+    struct Slot {
+        uint32_t dense{ Handle::INVALID };
+        uint32_t generation{ 0 };
+    };
+
+    std::vector<Slot>     m_slots;
+    std::vector<uint32_t> m_denseToSlot;
+    std::vector<uint32_t> m_freeSlots;
+};
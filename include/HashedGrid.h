@@ -0,0 +1,86 @@
+/* HashedGrid.h */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Aabb.h"
+#include "Frustum.h"
+#include "FrustumCulling.h"
+
+// Loose hashed uniform grid over object boxes
+// -------------------------------------------
+// Each object lives in the one cell holding its box center, and cells are
+// tested as their box grown by half a cell on every side, which bounds any
+// object no wider than a cell. Inserting, moving and removing objects are
+// O(1): a move only relinks the object when its center crosses a cell.
+// Objects wider than a cell, or centered beyond the +-2^20 cell coordinates
+// that keys can hold, are kept in a separate list that every query tests
+// directly. Only occupied cells are stored, keyed by their coordinates.
+// Queries match Bvh so a Scene can use either index, and likewise are not
+// safe to call concurrently.
+class HashedGrid {
+public:
+    explicit HashedGrid(float cellSize = 4.0f);
+
+    // Objects are identified by small integer ids chosen by the caller
+    void insert(uint32_t object, const Aabb& bounds);
+    void move(uint32_t object, const Aabb& bounds);
+    void remove(uint32_t object);
+    void clear();
+
+    void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& objects) const;
+    void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& objects) const;
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                 uint32_t& object, float& distance) const;
+
+    float cellSize() const { return m_cellSize; }
+    size_t objectCount() const { return m_objectCount; }
+    size_t cellCount() const { return m_cellLookup.size(); }
+
+private:
+    static const uint32_t NO_CELL = 0xFFFFFFFFu;
+    // Cell index standing for the list of objects no cell can hold: too large,
+    // or outside the coordinate range
+    static const uint32_t OVERSIZED = 0xFFFFFFFEu;
+
+    struct Cell {
+        glm::ivec3            coord;
+        std::vector<uint32_t> objects;
+    };
+
+    // Where an object is stored: its cell and its position in that cell's list
+    struct Entry {
+        uint32_t cell = NO_CELL;
+        uint32_t slot = 0;
+        Aabb     bounds;
+    };
+
+    bool fitsCell(const Aabb& bounds) const;
+    // Clamped to the packable range; fitsCell() keeps objects out of the clamped cells
+    glm::ivec3 cellCoord(const glm::vec3& p) const;
+    static uint64_t cellKey(const glm::ivec3& coord);
+    uint32_t cellFor(const Aabb& bounds);
+    std::vector<uint32_t>& listOf(uint32_t cell);
+    void link(uint32_t object, uint32_t cell);
+    void unlink(uint32_t object);
+    Aabb looseBounds(const Cell& cell) const;
+
+    float m_cellSize;
+    float m_invCellSize;
+    size_t m_objectCount = 0;
+
+    std::vector<Entry>                     m_entries;     // indexed by object id
+    std::vector<Cell>                      m_cells;
+    std::vector<uint32_t>                  m_freeCells;
+    std::unordered_map<uint64_t, uint32_t> m_cellLookup;  // occupied cells only
+    std::vector<uint32_t>                  m_oversized;
+
+    // Frustum query scratch: objects of straddling cells, batched for cullAabbs
+    mutable AabbBoundsSoA         m_candidates;
+    mutable std::vector<uint32_t> m_candidateObjects;
+    mutable std::vector<uint32_t> m_candidateVisible;
+};
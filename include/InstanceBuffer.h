@@ -0,0 +1,42 @@
+/* InstanceBuffer.h */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+// Per-instance attributes read by the instanced shaders
+struct InstanceData {
+    glm::mat4 model;
+    glm::mat3 normal;   // inverse transpose of the model's upper 3x3
+};
+
+// Instance attribute buffer
+// -------------------------
+// Holds one InstanceData per drawn object and feeds it to the vertex shader
+// through attributes with a divisor of 1, so a whole batch of objects is a
+// single glDraw*Instanced call.
+class InstanceBuffer {
+public:
+    // Attribute locations; must match the instanced vertex shaders
+    static const unsigned int MODEL_LOCATION = 3;    // mat4 takes 3..6
+    static const unsigned int NORMAL_LOCATION = 7;   // mat3 takes 7..9
+
+    void create();
+    // Enable the instance attributes on a VAO; the VAO keeps referring to this
+    // buffer, so attach once per VAO that draws from it
+    void attachTo(unsigned int vao) const;
+    // Replace the buffer contents; storage is orphaned so the GPU never stalls
+    // on instances still in flight from the previous frame
+    void upload(const InstanceData* instances, size_t count);
+    void upload(const std::vector<InstanceData>& instances) { upload(instances.data(), instances.size()); }
+    void release();
+
+    bool created() const { return m_vbo != 0; }
+    size_t count() const { return m_count; }
+
+private:
+    unsigned int m_vbo = 0;
+    size_t       m_capacity = 0;
+    size_t       m_count = 0;
+};
@@ -4,10 +4,14 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
-#include <memory>
-#include <string>
 
+#include "Frustum.h"
+#include "HandleTable.h"
+#include "InstanceBuffer.h"
+#include "MeshBuffer.h"
+#include "RenderQueue.h"
 #include "Shader.h"
+#include "ShaderBuffer.h"
 
 // Descriptor structs for light creation
 // --------------------------------------
@@ -41,63 +45,194 @@ struct SpotLightDesc {
     float     outerCutOff{ glm::cos(glm::radians(15.0f)) };
 };
 
-// Abstract base for all light types
-// ----------------------------------
-class Light {
-public:
-    virtual ~Light() = default;
-    // Upload the light's uniforms to the shader; index for arrays
-    virtual void uploadToShader(const Shader& shader, int index = 0) const = 0;
-    // Draw the light's visual shape
-    virtual void drawShape(const Shader& shader) const = 0;
+// GPU-side light layout
+// ----------------------
+// Mirrors the std140 "Lights" uniform block in lit_geometry.fs. Every vec3 is
+// followed by a scalar so each pair fills exactly one 16-byte std140 slot.
+
+struct DirLightStd140 {
+    glm::vec3 direction; float pad0;
+    glm::vec3 ambient;   float pad1;
+    glm::vec3 diffuse;   float pad2;
+    glm::vec3 specular;  float pad3;
 };
 
-// Concrete light implementations
-// ------------------------------
-class DirectionalLight : public Light {
-public:
-    DirectionalLight(const DirectionalLightDesc& desc);
-    void uploadToShader(const Shader& shader, int index = 0) const override;
-    void drawShape(const Shader& shader) const override;
+// Point lights live in their own array, bounded only by the storage limit
+// (GL 3.3 texture buffers guarantee 65536 texels, i.e. 16384 lights). The same
+// 64 bytes are a valid std430 element and four RGBA32F texels for the texture
+// buffer path.
+struct PointLightStd140 {
+    glm::vec3 position;  float constant;
+    glm::vec3 ambient;   float linear;
+    glm::vec3 diffuse;   float quadratic;
+    glm::vec3 specular;  float pad0;
+};
 
-private:
-    DirectionalLightDesc m_desc;
+struct SpotLightStd140 {
+    glm::vec3 position;  float constant;
+    glm::vec3 direction; float linear;
+    glm::vec3 ambient;   float quadratic;
+    glm::vec3 diffuse;   float cutOff;
+    glm::vec3 specular;  float outerCutOff;
 };
 
-class PointLight : public Light {
-public:
-    PointLight(const PointLightDesc& desc);
-    void uploadToShader(const Shader& shader, int index = 0) const override;
-    void drawShape(const Shader& shader) const override;
+struct LightsBlockStd140 {
+    DirLightStd140   dirLight;
+    SpotLightStd140  spotLight;
+    int              pointCount;
+    int              spotEnabled;   // 0 while the spot light is culled or absent
+    int              pad[2];
+};
 
-private:
-    PointLightDesc m_desc;
+static_assert(sizeof(DirLightStd140) == 64, "DirLight must match std140 layout");
+static_assert(sizeof(PointLightStd140) == 64, "PointLight must match std140 layout");
+static_assert(sizeof(SpotLightStd140) == 80, "SpotLight must match std140 layout");
+static_assert(sizeof(LightsBlockStd140) == 160, "Lights block must match std140 layout");
+
+enum class LightType {
+    Directional,
+    Point,
+    Spot,
 };
 
-class SpotLight : public Light {
-public:
-    SpotLight(const SpotLightDesc& desc);
-    void uploadToShader(const Shader& shader, int index = 0) const override;
-    void drawShape(const Shader& shader) const override;
+// Stable reference to a light; stays valid while other lights are removed
+struct LightHandle {
+    LightType type{ LightType::Point };
+    Handle    handle;
+};
 
-private:
-    SpotLightDesc m_desc;
+// Structure-of-arrays light pools
+// -------------------------------
+// Each field lives in its own contiguous array, indexed by the dense light
+// index. Removal swaps the last light into the hole so arrays stay packed.
+struct DirectionalLightPool {
+    std::vector<glm::vec3> direction, ambient, diffuse, specular;
+
+    size_t size() const { return direction.size(); }
+    void push(const DirectionalLightDesc& desc);
+    void set(size_t i, const DirectionalLightDesc& desc);
+    DirectionalLightDesc get(size_t i) const;
+    void removeSwap(size_t i);
+};
+
+struct PointLightPool {
+    std::vector<glm::vec3> position, ambient, diffuse, specular;
+    std::vector<float>     constant, linear, quadratic;
+    std::vector<float>     radius;   // influence radius, derived from attenuation
+
+    size_t size() const { return position.size(); }
+    void push(const PointLightDesc& desc);
+    void set(size_t i, const PointLightDesc& desc);
+    PointLightDesc get(size_t i) const;
+    void removeSwap(size_t i);
+};
+
+struct SpotLightPool {
+    std::vector<glm::vec3> position, direction, ambient, diffuse, specular;
+    std::vector<float>     constant, linear, quadratic, cutOff, outerCutOff;
+    std::vector<float>     radius;   // cone length, derived from attenuation
+
+    size_t size() const { return position.size(); }
+    void push(const SpotLightDesc& desc);
+    void set(size_t i, const SpotLightDesc& desc);
+    SpotLightDesc get(size_t i) const;
+    void removeSwap(size_t i);
 };
 
 // Manager for all lights
 // ----------------------
 class LightingManager {
 public:
+    // Picks where point lights are stored; the default queries the current context
+    explicit LightingManager(StorageBackend storage = preferredStorageBackend());
+
     // Factory methods
-    void addDirectional(const DirectionalLightDesc& desc);
-    void addPoint(const PointLightDesc& desc);
-    void addSpot(const SpotLightDesc& desc);
+    LightHandle addDirectional(const DirectionalLightDesc& desc);
+    LightHandle addPoint(const PointLightDesc& desc);
+    LightHandle addSpot(const SpotLightDesc& desc);
+
+    // Replace a light's parameters; returns false for stale or mistyped handles
+    bool updateDirectional(LightHandle light, const DirectionalLightDesc& desc);
+    bool updatePoint(LightHandle light, const PointLightDesc& desc);
+    bool updateSpot(LightHandle light, const SpotLightDesc& desc);
+    // Remove a light of any type; returns false for stale handles
+    bool remove(LightHandle light);
+    bool contains(LightHandle light) const;
+
+    // Lights reach until the luminance of their brightest term falls below this
+    // value; changing it recomputes every radius. Clamped to at least 1e-4.
+    void setInfluenceThreshold(float luminance);
+    float influenceThreshold() const { return m_influenceThreshold; }
+
+    // Flag lights whose influence volume misses the frustum. Culled lights are
+    // skipped by upload() and clustering until they become visible again.
+    void cull(const Frustum& frustum);
+    const std::vector<uint8_t>& pointVisibility() const { return m_pointVisible; }
+    size_t visiblePointCount() const { return m_visiblePointCount; }
 
-    // Upload all light uniforms to shader
-    void uploadToShader(const Shader& shader) const;
-    // Draw all light shapes
-    void drawShapes(const Shader& shader) const;
+    // Read-only access to the packed pools
+    const DirectionalLightPool& directionalLights() const { return m_directional; }
+    const PointLightPool& pointLights() const { return m_point; }
+    const SpotLightPool& spotLights() const { return m_spot; }
+
+    // Binding point shared by every shader that declares the "Lights" block
+    static const unsigned int LIGHTS_BINDING = 0;
+    // Where the point light array is attached; must match lit_geometry.fs
+    static const unsigned int POINT_LIGHTS_SSBO_BINDING = 1;
+    static const unsigned int POINT_LIGHTS_TEXTURE_UNIT = 15;
+
+    StorageBackend storageBackend() const { return m_pointStorage.backend(); }
+    // Point lights the shaders can see: the pool size capped at what the
+    // point storage could hold. Lights past this are not lit or clustered.
+    size_t residentPointCount() const;
+    // Options every lit shader must be compiled with to match the storage backend
+    ShaderOptions shaderOptions() const { return shaderOptionsFor(storageBackend()); }
+
+    // Point a shader's light inputs at the shared buffers; call once per shader
+    void bindToShader(const Shader& shader) const;
+    // Re-pack and upload only the lights changed since the last upload
+    void upload();
+    // Submit all visible light shapes as one instanced draw of a shared mesh
+    void enqueueShapes(RenderQueue& queue, uint64_t key, const MeshBuffer& meshes, const MeshRange& shape);
+    // Free GPU resources; call before the GL context is destroyed
+    void release();
 
 private:
-    std::vector<std::unique_ptr<Light>> m_lights;
+    HandleTable& tableFor(LightType type);
+    const HandleTable& tableFor(LightType type) const;
+    void markPointDirty(size_t index);
+    float influenceRadius(const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular,
+                          float constant, float linear, float quadratic) const;
+    void packHeader();
+    void packPoint(size_t index);
+
+    DirectionalLightPool m_directional;
+    PointLightPool       m_point;
+    SpotLightPool        m_spot;
+    HandleTable          m_directionalHandles;
+    HandleTable          m_pointHandles;
+    HandleTable          m_spotHandles;
+
+    // Dirty tracking: the block header (directional, spot, point count) is
+    // re-sent as a unit, point lights are re-sent as runs of dirty indices
+    bool                 m_headerDirty = true;
+    std::vector<uint8_t> m_pointDirty;
+    bool                 m_anyPointDirty = false;
+
+    // Visibility from the last cull(); everything is visible until then
+    float                m_influenceThreshold = 5.0f / 256.0f;
+    std::vector<uint8_t> m_pointVisible;
+    size_t               m_visiblePointCount = 0;
+    bool                 m_spotVisible = true;
+
+    LightsBlockStd140             m_block{};
+    unsigned int                  m_ubo = 0;
+    std::vector<PointLightStd140> m_pointData;
+    ShaderBuffer                  m_pointStorage;
+
+    // Light gizmo instances, rebuilt each enqueueShapes()
+    std::vector<InstanceData>     m_gizmoData;
+    InstanceBuffer                m_gizmoInstances;
+    unsigned int                  m_gizmoVAO = 0;
+    const MeshBuffer*             m_gizmoSource = nullptr;
 };
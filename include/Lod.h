@@ -0,0 +1,28 @@
+/* Lod.h */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstdint>
+
+// Pixels covered by one world unit at distance 1 for a perspective projection
+inline float lodProjectionScale(float fovY, float viewportHeight)
+{
+    return viewportHeight / (2.0f * std::tan(fovY * 0.5f));
+}
+
+// Pick the coarsest level whose geometric error, projected at the given
+// distance, stays within maxPixelError. levelErrors must be non-decreasing.
+inline uint32_t selectLod(const float* levelErrors, uint32_t levelCount, float distance,
+                          float projectionScale, float maxPixelError = 1.0f)
+{
+    if (distance <= 0.0f)
+        return 0;
+    uint32_t level = 0;
+    for (uint32_t l = 1; l < levelCount; ++l) {
+        if (levelErrors[l] / distance * projectionScale > maxPixelError)
+            break;
+        level = l;
+    }
+    return level;
+}
@@ -0,0 +1,47 @@
+/* MappedFile.h */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory-mapped file
+// ----------------------------
+// Maps a whole file into the address space so its bytes can be handed to GL
+// without an intermediate copy; pages are faulted in by the OS on first touch.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Map an existing, non-empty file; returns false if it cannot be mapped
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    void swap(MappedFile& other) noexcept;
+
+    const uint8_t* m_data = nullptr;
+    size_t         m_size = 0;
+#ifdef _WIN32
+    void*          m_file = nullptr;      // HANDLE
+    void*          m_mapping = nullptr;   // HANDLE
+#else
+    int            m_fd = -1;
+#endif
+};
+
+// 64-bit FNV-1a of a file's contents; 0 if it cannot be read
+uint64_t hashFile(const std::string& path);
+// Fold value into an FNV-1a hash
+uint64_t hashCombine(uint64_t hash, uint64_t value);
+
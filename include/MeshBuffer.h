@@ -0,0 +1,109 @@
+/* MeshBuffer.h */
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Shader.h"
+
+// Interleaved vertex used by the lit geometry pipeline (attributes 0, 1, 2)
+struct Vertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoords;
+};
+
+// GPU encodings for each vertex attribute. The CPU side always works with
+// full-precision Vertex data; the buffer packs it on upload.
+enum class PositionFormat { Float3, Unorm16 };       // Unorm16: relative to the mesh bounds
+enum class NormalFormat   { Float3, Octahedral10 };  // Octahedral10: two snorm10 in 2_10_10_10_REV, z and w zero
+enum class TexCoordFormat { Float2, Half2 };
+
+struct VertexFormat {
+    PositionFormat position = PositionFormat::Float3;
+    NormalFormat   normal = NormalFormat::Float3;
+    TexCoordFormat texCoords = TexCoordFormat::Float2;
+
+    // 16 bytes per vertex instead of 32
+    static VertexFormat compact()
+    {
+        return VertexFormat{ PositionFormat::Unorm16, NormalFormat::Octahedral10, TexCoordFormat::Half2 };
+    }
+
+    size_t stride() const;
+    bool quantizedPositions() const { return position == PositionFormat::Unorm16; }
+};
+
+// Add the defines that make lit_geometry.vs / light_cube.vs decode this format
+void addVertexFormatDefines(const VertexFormat& format, ShaderOptions& options);
+
+// Where one mesh lives inside a MeshBuffer. Indices are relative to
+// baseVertex, so each mesh only needs to fit its own vertex count.
+struct MeshRange {
+    uint32_t firstIndex{ 0 };
+    uint32_t indexCount{ 0 };
+    int32_t  baseVertex{ 0 };
+    uint32_t vertexCount{ 0 };
+    // Maps quantized [0, 1] positions back to model space: offset + q * scale.
+    // RenderQueue sets them as the positionOffset/positionScale uniforms.
+    glm::vec3 positionOffset{ 0.0f };
+    glm::vec3 positionScale{ 1.0f };
+};
+
+// Shared vertex/index storage
+// ---------------------------
+// Packs many meshes into one VBO and one IBO so they can all be drawn from a
+// single VAO with glDrawElementsBaseVertex. Indices are stored as 16-bit when
+// every mesh has at most 65536 vertices, 32-bit otherwise.
+class MeshBuffer {
+public:
+    explicit MeshBuffer(const VertexFormat& format = VertexFormat()) : m_format(format) {}
+
+
+    // Append an indexed mesh; indices are relative to the mesh's own vertices
+    MeshRange add(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount);
+    MeshRange add(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+    {
+        return add(vertices.data(), vertices.size(), indices.data(), indices.size());
+    }
+    // Append another index list over a mesh's existing vertices, e.g. a LOD
+    MeshRange addLod(const MeshRange& mesh, const uint32_t* indices, size_t indexCount);
+    // Append an unindexed triangle list, merging bit-identical vertices
+    MeshRange addDeduplicated(const Vertex* vertices, size_t count);
+
+    // Upload everything added so far and (re)build the default VAO
+    void upload();
+    // Extra VAO over the same storage, e.g. to pair it with another instance buffer
+    unsigned int createVertexArray() const;
+
+    unsigned int vao() const { return m_vao; }
+    void bind() const { glBindVertexArray(m_vao); }
+    // Draw calls assume a VAO of this buffer is bound
+    void draw(const MeshRange& mesh) const;
+    void drawInstanced(const MeshRange& mesh, GLsizei instanceCount) const;
+    void release();
+
+    size_t vertexCount() const { return m_vertices.size(); }
+    size_t indexCount() const { return m_indices.size(); }
+    GLenum indexType() const { return m_indexType; }
+    const VertexFormat& format() const { return m_format; }
+
+private:
+    const void* indexOffset(const MeshRange& mesh) const;
+    void setupVertexAttributes() const;
+    std::vector<uint8_t> packVertices() const;
+
+    VertexFormat          m_format;
+    std::vector<Vertex>   m_vertices;
+    std::vector<uint32_t> m_indices;
+    std::vector<MeshRange> m_ranges;
+    uint32_t              m_largestMesh = 0;
+
+    GLenum       m_indexType = GL_UNSIGNED_SHORT;
+    unsigned int m_vao = 0;
+    unsigned int m_vbo = 0;
+    unsigned int m_ebo = 0;
+};
@@ -0,0 +1,45 @@
+/* MeshCache.h */
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "MappedFile.h"
+#include "ModelData.h"
+
+// Binary mesh cache (.mesh)
+// -------------------------
+// A ModelData snapshot tagged with a hash of everything it was built from: the
+// source file, the material libraries it references and the import flags.
+// Reading memory-maps the file and copies the arrays out, so a warm start
+// never runs the importer:
+//
+//   MeshCacheHeader | Vertex[] | uint32_t[] indices | SubMeshData[] | MaterialRecord[] | LodData[]
+struct MeshCacheHeader {
+    static const uint32_t MAGIC = 0x4D52474Fu;   // "OGRM"
+    static const uint32_t VERSION = 5;           // bump when the layout or post-import processing changes
+
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t subMeshCount;
+    uint32_t materialCount;
+    float    boundsMin[3];
+    float    boundsMax[3];
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t subMeshOffset;
+    uint64_t materialOffset;
+    uint32_t lodCount;
+    uint32_t reserved;
+    uint64_t lodOffset;
+};
+
+static_assert(sizeof(MeshCacheHeader) == 104, "MeshCacheHeader layout is part of the file format");
+
+bool writeMeshCache(const std::string& path, uint64_t sourceHash, const ModelData& model);
+// Fails if the file is missing, malformed (including out-of-range indices) or
+// was built from a different source
+bool readMeshCache(const std::string& path, uint64_t expectedHash, ModelData& model);
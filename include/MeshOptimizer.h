@@ -0,0 +1,42 @@
+/* MeshOptimizer.h */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "MeshBuffer.h"
+#include "ModelData.h"
+
+// Post-transform vertex cache efficiency of an index list, simulated with a FIFO
+struct VertexCacheStats {
+    float acmr = 0.0f;   // average cache miss ratio: transformed vertices per triangle (0.5 .. 3)
+    float atvr = 0.0f;   // average transform to vertex ratio: transformed / referenced vertices (1 is ideal)
+};
+
+const unsigned int DEFAULT_FIFO_CACHE_SIZE = 16;
+
+VertexCacheStats analyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                    unsigned int cacheSize = DEFAULT_FIFO_CACHE_SIZE);
+
+// Reorder triangles for the post-transform cache (Forsyth's linear-speed
+// algorithm with a simulated 32-entry LRU). dst may alias indices.
+void optimizeVertexCache(uint32_t* dst, const uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+// Split a cache-optimized index list into clusters at cache restarts and sort
+// them front-facing-outward first, so outer surfaces occlude inner ones early.
+// threshold > 1 allows extra, smaller clusters as long as ACMR stays within it.
+void optimizeOverdraw(uint32_t* dst, const uint32_t* indices, size_t indexCount,
+                      const Vertex* vertices, size_t vertexCount, float threshold = 1.05f);
+
+// Renumber vertices in first-use order and move them to match, so vertex
+// fetch walks memory linearly. Unreferenced vertices are dropped; returns the
+// new vertex count.
+size_t optimizeVertexFetch(Vertex* vertices, uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+struct MeshOptimizationReport {
+    VertexCacheStats before;
+    VertexCacheStats after;
+};
+
+// Run all three passes on every sub-mesh; triangle-weighted stats over the model
+MeshOptimizationReport optimizeModel(ModelData& model);
@@ -0,0 +1,29 @@
+/* MeshSimplifier.h */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "MeshBuffer.h"
+#include "ModelData.h"
+
+// Reduce a triangle list by quadric error metric edge collapses (Garland and
+// Heckbert). Vertices are never moved or created: a vertex collapses onto a
+// neighbour, so the result indexes the same vertex array. Vertices on
+// attribute seams only collapse along the seam, with each side keeping its
+// own wedge, which keeps UV charts crack-free; open borders and seam corners
+// stay put. Collapses are ranked by area-weighted RMS plane distance but
+// limited and reported by an upper bound on the largest distance from a
+// collapsed vertex to any plane it absorbed. Stops at targetIndexCount or when
+// every remaining collapse would exceed maxError (model-space distance);
+// resultError receives the largest bound taken. Returns the new index count;
+// dst may alias indices.
+size_t simplifyMesh(uint32_t* dst, const uint32_t* indices, size_t indexCount,
+                    const Vertex* vertices, size_t vertexCount,
+                    size_t targetIndexCount, float maxError, float* resultError = nullptr);
+
+const uint32_t MAX_LOD_LEVELS = 5;   // including the full-detail level
+
+// Append simplified index lists (half the triangles per level) for every
+// sub-mesh to model.lods. Levels that barely shrink end a sub-mesh's chain.
+void buildLodChain(ModelData& model);
@@ -0,0 +1,82 @@
+/* Meshlet.h */
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Frustum.h"
+#include "MeshBuffer.h"
+
+const size_t MESHLET_MAX_VERTICES = 64;
+const size_t MESHLET_MAX_TRIANGLES = 124;
+
+// A small cluster of a mesh: up to 64 unique vertices and 124 triangles whose
+// corners index into the meshlet's own vertex list
+struct Meshlet {
+    uint32_t vertexOffset;     // into MeshletData::vertices
+    uint32_t triangleOffset;   // into MeshletData::triangles, three bytes per triangle
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+};
+
+// Model-space culling volumes of a meshlet
+struct MeshletBounds {
+    glm::vec3 center;
+    float     radius;
+    glm::vec3 coneAxis;     // average facing direction of the triangles
+    float     coneCutoff;   // sine of the normal cone's half angle; 1 disables cone culling
+};
+
+struct MeshletData {
+    std::vector<Meshlet>       meshlets;
+    std::vector<MeshletBounds> bounds;
+    std::vector<uint32_t>      vertices;    // mesh-relative vertex indices
+    std::vector<uint8_t>       triangles;   // meshlet-relative corners
+};
+
+// Split a triangle list into meshlets in index order. Feed it a
+// vertex-cache-optimized list so consecutive triangles are spatially coherent.
+void buildMeshlets(MeshletData& out, const uint32_t* indices, size_t indexCount,
+                   const Vertex* vertices, size_t vertexCount,
+                   size_t maxVertices = MESHLET_MAX_VERTICES, size_t maxTriangles = MESHLET_MAX_TRIANGLES);
+
+// Collect the meshlets that are inside the frustum and not entirely back-facing
+// for an instance at the given transform. Tests run in model space, so any
+// affine transform is handled exactly. Returns the number written to visible.
+size_t cullMeshlets(const MeshletData& data, const glm::mat4& transform, const glm::vec3& viewPosition,
+                    const Frustum& frustum, std::vector<uint32_t>& visible);
+
+// Contiguous run of indices in a MeshletStream
+struct MeshletDraw {
+    uint32_t firstIndex{ 0 };
+    uint32_t indexCount{ 0 };
+};
+
+// Per-frame index stream
+// ----------------------
+// Visible meshlets are expanded to plain indices and streamed into a dynamic
+// element buffer. Attach it to a VAO of the mesh buffer (replacing that VAO's
+// element buffer) and draw each run as 32-bit indices from its firstIndex,
+// with its mesh's base vertex.
+class MeshletStream {
+public:
+    void create();
+    void attachTo(unsigned int vao) const;
+
+    // Start a new frame's stream
+    void reset() { m_indices.clear(); }
+    MeshletDraw append(const MeshletData& data, const uint32_t* visible, size_t count);
+    // Orphan and refill the element buffer with everything appended since reset()
+    void upload();
+    void release();
+
+    size_t indexCount() const { return m_indices.size(); }
+
+private:
+    std::vector<uint32_t> m_indices;
+    unsigned int          m_ebo = 0;
+    size_t                m_capacity = 0;
+};
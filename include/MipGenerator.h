@@ -0,0 +1,32 @@
+/* MipGenerator.h */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class MipFilter {
+    Box,     // 2x2 average
+    Kaiser   // Kaiser-windowed sinc over 6 taps; sharper, less aliasing
+};
+
+struct MipOptions {
+    MipFilter filter{ MipFilter::Box };
+    bool      srgb{ false };        // average color channels in linear space
+    bool      normalMap{ false };   // renormalize the decoded XYZ of each texel
+};
+
+struct MipLevel {
+    uint32_t             width;
+    uint32_t             height;
+    std::vector<uint8_t> data;   // tightly packed, same channel count as the source
+};
+
+// CPU mip chain builder
+// ---------------------
+// Builds every level down to 1x1 from an 8-bit image with 1-4 channels;
+// level 0 is a copy of the source. Filtering is separable and runs on float
+// RGBA rows with SSE (AVX when the CPU has it; both give identical results),
+// so it is deterministic and safe to call from worker threads.
+std::vector<MipLevel> generateMipChain(const uint8_t* pixels, uint32_t width, uint32_t height,
+                                       int components, const MipOptions& options = MipOptions());
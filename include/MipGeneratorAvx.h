@@ -0,0 +1,10 @@
+/* MipGeneratorAvx.h */
+#pragma once
+
+#include <cstddef>
+
+// 8-wide AVX kernel behind the vertical mip filter pass. Built in its own
+// translation unit with AVX enabled; only call it when cpuSupportsAvx().
+// Computes dst = sum_k weights[k] * rows[k] over floats [0, count & ~7) and
+// returns how many it wrote; a build without AVX writes none.
+size_t blendRowsAvx(const float* const* rows, const float* weights, int taps, float* dst, size_t count);
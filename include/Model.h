@@ -0,0 +1,76 @@
+/* Model.h */
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+
+#include "Frustum.h"
+#include "MeshBuffer.h"
+#include "Meshlet.h"
+#include "ModelData.h"
+#include "RenderQueue.h"
+#include "TextureCache.h"
+
+// Run the Assimp importer on a model file (triangulated, node transforms baked in)
+bool importModel(const std::string& path, ModelData& model);
+
+// Imported model
+// --------------
+// load() reads the binary mesh cache when it matches the source file's hash
+// and only falls back to Assimp (then rewrites the cache) when it does not.
+// Sub-meshes are appended to a shared MeshBuffer and their textures come from
+// the TextureCache, so several models share one VAO and their images.
+class Model {
+public:
+    // Call before meshes.upload(); returns false if the file cannot be imported.
+    // Each imported material and its maps are registered with queue here.
+    bool load(const std::string& path, MeshBuffer& meshes, TextureCache& textures, RenderQueue& queue);
+    // Submit every sub-mesh under key, with the material and texture set
+    // fields replaced by its own, drawn through vao (a VAO of the mesh
+    // buffer with an instance stream) when the queue is flushed. Sub-meshes
+    // with a shorter LOD chain use their coarsest level.
+    void enqueue(RenderQueue& queue, uint64_t key, const MeshBuffer& meshes, unsigned int vao,
+                 GLsizei instanceCount, uint32_t lod = 0) const;
+    // Full detail, but only the meshlets inside the frustum and facing the
+    // viewer, for a single instance at the given transform. The stream must be
+    // attached to vao; returns the number of meshlets submitted.
+    size_t enqueueCulled(RenderQueue& queue, uint64_t key, const MeshBuffer& meshes, MeshletStream& stream,
+                         unsigned int vao, const glm::mat4& transform, const glm::vec3& viewPosition,
+                         const Frustum& frustum);
+    // LOD whose error projects to at most maxPixelError for an instance at the
+    // given transform; see lodProjectionScale()
+    uint32_t selectLod(const glm::mat4& transform, const glm::vec3& viewPosition,
+                       float projectionScale, float maxPixelError = 1.0f) const;
+    // Drop the texture references taken by load()
+    void release(TextureCache& textures);
+
+    // Directory of .mesh files; created on first write
+    void setCacheDirectory(const std::string& directory) { m_cacheDirectory = directory; }
+
+    const glm::vec3& boundsMin() const { return m_boundsMin; }
+    const glm::vec3& boundsMax() const { return m_boundsMax; }
+    bool loadedFromCache() const { return m_loadedFromCache; }
+    uint32_t lodCount() const { return (uint32_t)m_lodErrors.size(); }
+    size_t meshletCount() const;
+
+private:
+    struct DrawItem {
+        std::vector<MeshRange> levels;   // full detail first
+        MeshletData            meshlets; // of the full-detail level
+        MeshletDraw            culled;   // this frame's run in the meshlet stream
+        uint32_t material;     // RenderQueue ids
+        uint32_t textureSet;
+    };
+
+    std::string cachePathFor(const std::string& path) const;
+
+    std::vector<DrawItem>     m_items;
+    std::vector<unsigned int> m_textures;
+    std::vector<float>        m_lodErrors;   // worst sub-mesh error per level
+    std::vector<uint32_t>     m_visibleMeshlets;
+    glm::vec3                 m_boundsMin{ 0.0f };
+    glm::vec3                 m_boundsMax{ 0.0f };
+    std::string               m_cacheDirectory = "cache";
+    bool                      m_loadedFromCache = false;
+};
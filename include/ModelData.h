@@ -0,0 +1,52 @@
+/* ModelData.h */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MeshBuffer.h"
+
+// Texture paths are relative to the model's directory; empty when unused
+struct MaterialData {
+    std::string diffuse;
+    std::string specular;
+    std::string normal;
+    float       shininess{ 32.0f };
+};
+
+// One draw's worth of a model. Indices are relative to baseVertex, as in MeshBuffer.
+struct SubMeshData {
+    uint32_t  firstIndex;
+    uint32_t  indexCount;
+    int32_t   baseVertex;
+    uint32_t  vertexCount;
+    uint32_t  material;
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+};
+
+static_assert(sizeof(SubMeshData) == 44, "SubMeshData is stored verbatim in the mesh cache");
+
+// Simplified index list of a sub-mesh over the same vertices. Levels of one
+// sub-mesh are stored together, finest first.
+struct LodData {
+    uint32_t subMesh;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float    error;        // bound on the model-space distance to the full-detail triangle planes
+};
+
+static_assert(sizeof(LodData) == 16, "LodData is stored verbatim in the mesh cache");
+
+// CPU-side model: what the importer produces and the mesh cache stores
+struct ModelData {
+    std::vector<Vertex>       vertices;
+    std::vector<uint32_t>     indices;
+    std::vector<SubMeshData>  subMeshes;
+    std::vector<LodData>      lods;
+    std::vector<MaterialData> materials;
+    glm::vec3                 boundsMin{ 0.0f };
+    glm::vec3                 boundsMax{ 0.0f };
+};
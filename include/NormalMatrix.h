@@ -0,0 +1,20 @@
+/* NormalMatrix.h */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+#include "InstanceBuffer.h"
+
+// Normal matrices (inverse transpose of the model's upper 3x3)
+// ------------------------------------------------------------
+// Computed once per object on the CPU instead of once per vertex in the shader.
+// Rotation + uniform scale takes a fast path that needs no inverse at all;
+// anything else uses the cross-product form of the inverse transpose.
+
+glm::mat3 computeNormalMatrix(const glm::mat4& model);
+
+// Batched versions, processed one matrix per SSE iteration when available
+void computeNormalMatrices(const glm::mat4* models, glm::mat3* normals, size_t count);
+// Fills InstanceData::normal from InstanceData::model in place
+void computeNormalMatrices(InstanceData* instances, size_t count);
@@ -0,0 +1,53 @@
+/* OcclusionCulling.h */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Aabb.h"
+
+// Software occlusion culling
+// --------------------------
+// Occluder meshes are rasterized on the CPU into a small depth buffer, which
+// is reduced into a hierarchical-Z pyramid holding the farthest depth of each
+// texel's footprint. Object boxes are then rejected when their nearest depth
+// lies behind everything stored over the screen rectangle they cover. Depth
+// is NDC z remapped to [0, 1], so a frame goes: begin(), rasterize() each
+// occluder, buildHiZ(), then isVisible() per candidate.
+//
+// Occluders are sampled at texel centers, so they should be solid, fairly
+// large meshes (walls, crates); thin or partially transparent geometry makes
+// a poor occluder. Triangles are rasterized double-sided.
+class OcclusionBuffer {
+public:
+    // Width is rounded up to a multiple of four for the SIMD row loop
+    explicit OcclusionBuffer(int width = 256, int height = 128);
+
+    // Clear depth to the far plane for a new view
+    void begin(const glm::mat4& viewProjection);
+    // Indexed triangle list in the space transform maps from
+    void rasterize(const glm::vec3* positions, const uint32_t* indices, size_t indexCount,
+                   const glm::mat4& transform);
+    void buildHiZ();
+
+    // False only when the box is certainly hidden behind the occluders
+    bool isVisible(const Aabb& bounds) const;
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    size_t levelCount() const { return m_levels.size(); }
+    // Level 0 is the full resolution depth buffer
+    const float* depth(size_t level = 0) const { return m_levels[level].data(); }
+
+private:
+    void drawTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+
+    int m_width;
+    int m_height;
+    glm::mat4 m_viewProjection{ 1.0f };
+
+    std::vector<std::vector<float>> m_levels;
+    std::vector<glm::ivec2>         m_levelSize;
+};
@@ -0,0 +1,10 @@
+/* Primitives.h */
+#pragma once
+
+#include <vector>
+
+#include "MeshBuffer.h"
+
+// Unit cube centred on the origin as an unindexed triangle list (36 vertices).
+// Add it with MeshBuffer::addDeduplicated to get the shared 24-vertex mesh.
+const std::vector<Vertex>& cubeTriangles();
@@ -0,0 +1,116 @@
+/* RenderQueue.h */
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "MeshBuffer.h"
+#include "Shader.h"
+
+// Passes are submitted in increasing order; later passes (translucent,
+// overlays) take higher values
+enum RenderPass : uint32_t {
+    RENDER_PASS_OPAQUE = 0,
+};
+
+// Sort keys
+// ---------
+// Fields from most to least significant, so sorted draws are grouped by the
+// state that is most expensive to change:
+//   pass 4 | shader 8 | material 12 | texture set 12 | depth 24 | unused 4
+// Depth is view distance over the far plane in [0, 1], quantized so nearer
+// draws come first within equal state.
+uint64_t makeSortKey(uint32_t pass, uint32_t shader, uint32_t material, uint32_t textureSet, float depth);
+// Same key with its material or texture set field replaced
+uint64_t withMaterial(uint64_t key, uint32_t material);
+uint64_t withTextureSet(uint64_t key, uint32_t textureSet);
+
+// One indexed, instanced draw through a VAO over a MeshBuffer
+struct RenderItem {
+    unsigned int vao = 0;
+    GLenum       indexType = GL_UNSIGNED_INT;
+    uint32_t     firstIndex = 0;
+    uint32_t     indexCount = 0;
+    int32_t      baseVertex = 0;
+    GLsizei      instanceCount = 1;
+    // Position decode uniforms, set only for quantized vertex formats
+    bool         decodePositions = false;
+    glm::vec3    positionOffset{ 0.0f };
+    glm::vec3    positionScale{ 1.0f };
+};
+
+// Item drawing a range of the buffer's own index storage through vao
+RenderItem makeRenderItem(const MeshBuffer& meshes, unsigned int vao, const MeshRange& range, GLsizei instanceCount);
+
+struct RenderQueueStats {
+    size_t draws = 0;
+    size_t shaderChanges = 0;
+    size_t materialChanges = 0;
+    size_t textureBinds = 0;
+    size_t vertexArrayChanges = 0;
+};
+
+// Render queue
+// ------------
+// Draws are recorded with a sort key instead of being issued on the spot.
+// Each frame the keys are radix sorted and the draws issued in key order,
+// changing program, material uniforms, textures and VAO only when the
+// corresponding key field or item state differs from the previous draw.
+// Shaders, materials and texture sets are registered once; their ids are
+// what the keys hold. Per-frame uniforms (matrices, view position) are set
+// on the shaders before flush().
+class RenderQueue {
+public:
+    static const int TEXTURE_SET_UNITS = 2;   // diffuse, specular
+    // Texture set that binds nothing, for untextured shaders
+    static const uint32_t NO_TEXTURES = 0;
+
+    RenderQueue();
+
+    // Up to 256 shaders and 4096 materials and texture sets
+    uint32_t addShader(const Shader& shader);
+    uint32_t addMaterial(float shininess);
+    // Returns the existing id when the pair was added before
+    uint32_t addTextureSet(unsigned int diffuse, unsigned int specular);
+
+    void clear();
+    void submit(uint64_t key, const RenderItem& item);
+    // Stable LSD radix sort of the recorded draws by key
+    void sort();
+    // Issue the draws in sorted order
+    void flush();
+
+    size_t size() const { return m_items.size(); }
+    const RenderQueueStats& stats() const { return m_stats; }
+
+private:
+    struct ShaderState {
+        const Shader* shader;
+        UniformHandle shininess;
+        UniformHandle positionOffset;
+        UniformHandle positionScale;
+    };
+
+    struct TextureSet {
+        unsigned int textures[TEXTURE_SET_UNITS];
+    };
+
+    struct SortEntry {
+        uint64_t key;
+        uint32_t item;
+    };
+
+    std::vector<ShaderState>               m_shaders;
+    std::vector<float>                     m_materials;
+    std::vector<TextureSet>                m_textureSets;
+    std::unordered_map<uint64_t, uint32_t> m_textureSetLookup;
+
+    std::vector<RenderItem> m_items;
+    std::vector<SortEntry>  m_order;
+    std::vector<SortEntry>  m_scratch;
+    RenderQueueStats        m_stats;
+};
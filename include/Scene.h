@@ -0,0 +1,75 @@
+/* Scene.h */
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Aabb.h"
+#include "Bvh.h"
+#include "Frustum.h"
+#include "HandleTable.h"
+#include "HashedGrid.h"
+#include "InstanceBuffer.h"
+
+// Which spatial index a scene layer keeps its objects in
+// -------------------------------------------------------
+enum class SpatialIndexType {
+    Bvh,          // tight queries; best when most objects stay put
+    HashedGrid,   // O(1) insert/move/remove; for layers that churn every frame
+};
+
+// Scene objects
+// -------------
+// Dense arrays of instance transforms and world bounds behind stable handles,
+// indexed by the spatial index chosen for the layer. With a BVH, moving
+// objects only marks the tree for a refit; adding or removing them, or refits
+// degrading the tree's SAH cost past the rebuild threshold, schedules a full
+// rebuild. The grid is updated in place as objects change. Call update() once
+// per frame before querying.
+class Scene {
+public:
+    explicit Scene(SpatialIndexType index = SpatialIndexType::Bvh, float gridCellSize = 4.0f);
+
+    Handle add(const glm::mat4& transform, const Aabb& localBounds);
+    void remove(Handle object);
+    void setTransform(Handle object, const glm::mat4& transform);
+    bool contains(Handle object) const { return m_handles.contains(object); }
+
+    // Bring the BVH in line with this frame's transforms
+    void update();
+    // Dense indices of the objects whose bounds touch the frustum
+    void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+    // Dense indices of the objects whose bounds touch the sphere
+    void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& objects) const;
+    // Nearest object whose world bounds the ray hits; a null handle on a miss
+    Handle pick(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                float* distance = nullptr) const;
+
+    // Rebuild once refits push the SAH cost past this multiple of a fresh build
+    void setRebuildThreshold(float threshold) { m_rebuildThreshold = threshold; }
+
+    SpatialIndexType indexType() const { return m_indexType; }
+    size_t size() const { return m_instances.size(); }
+    const InstanceData& instance(uint32_t index) const { return m_instances[index]; }
+    const Aabb& worldBounds(uint32_t index) const { return m_worldBounds[index]; }
+    Handle handleAt(uint32_t index) const { return m_handles.handleAt(index); }
+    size_t rebuildCount() const { return m_rebuilds; }
+
+private:
+    void rebuild();
+
+    HandleTable               m_handles;
+    std::vector<InstanceData> m_instances;
+    std::vector<Aabb>         m_localBounds;
+    std::vector<Aabb>         m_worldBounds;
+
+    SpatialIndexType m_indexType;
+    Bvh              m_bvh;
+    HashedGrid       m_grid;
+    bool             m_structureDirty = false;
+    bool             m_boundsDirty = false;
+    float            m_rebuildThreshold = 1.3f;
+    size_t           m_rebuilds = 0;
+};
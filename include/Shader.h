@@ -8,6 +8,25 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
+
+// Optional source tweaks applied to every stage before compiling, so one shader
+// file can be built in several variants.
+struct ShaderOptions
+{
+    std::string version;               // replaces the file's #version line when set, e.g. "430 core"
+    std::vector<std::string> defines;  // emitted as "#define <entry>" right after #version
+};
+
+// Resolved uniform location. Look it up once with Shader::uniform() and pass it
+// to the set* overloads to skip the name lookup entirely.
+struct UniformHandle
+{
+    GLint location = -1;
+
+    bool valid() const { return location >= 0; }
+};
 
 class Shader
 {
@@ -15,7 +34,7 @@ public:
     unsigned int ID;
     // constructor generates the shader on the fly
     // ------------------------------------------------------------------------
-    Shader(const char* vertexPath, const char* fragmentPath)
+    Shader(const char* vertexPath, const char* fragmentPath, const ShaderOptions& options = ShaderOptions())
     {
         // 1. retrieve the vertex/fragment source code from filePath
         std::string vertexCode;
@@ -45,6 +64,8 @@ public:
         {
             std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
         }
+        vertexCode = applyOptions(vertexCode, options);
+        fragmentCode = applyOptions(fragmentCode, options);
         const char* vShaderCode = vertexCode.c_str();
         const char* fShaderCode = fragmentCode.c_str();
         // 2. compile shaders
@@ -68,7 +89,8 @@ public:
         // delete the shaders as they're linked into our program now and no longer necessary
         glDeleteShader(vertex);
         glDeleteShader(fragment);
-
+        // 3. cache the location of every active uniform
+        reflectUniforms();
     }
     // activate the shader
     // ------------------------------------------------------------------------
@@ -76,66 +98,181 @@ public:
     {
         glUseProgram(ID);
     }
+    // uniform lookup
+    // ------------------------------------------------------------------------
+    // returns the cached location of an active uniform, or -1 if the linker optimized it away
+    GLint getUniformLocation(const std::string& name) const
+    {
+        auto it = m_uniformLocations.find(name);
+        return it != m_uniformLocations.end() ? it->second : -1;
+    }
+    UniformHandle uniform(const std::string& name) const
+    {
+        return UniformHandle{ getUniformLocation(name) };
+    }
     // utility uniform functions
     // ------------------------------------------------------------------------
     void setBool(const std::string& name, bool value) const
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+        glUniform1i(getUniformLocation(name), (int)value);
+    }
+    void setBool(UniformHandle handle, bool value) const
+    {
+        glUniform1i(handle.location, (int)value);
     }
     // ------------------------------------------------------------------------
     void setInt(const std::string& name, int value) const
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+        glUniform1i(getUniformLocation(name), value);
+    }
+    void setInt(UniformHandle handle, int value) const
+    {
+        glUniform1i(handle.location, value);
     }
     // ------------------------------------------------------------------------
     void setFloat(const std::string& name, float value) const
     {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+        glUniform1f(getUniformLocation(name), value);
+    }
+    void setFloat(UniformHandle handle, float value) const
+    {
+        glUniform1f(handle.location, value);
     }
     // ------------------------------------------------------------------------
     void setVec2(const std::string& name, const glm::vec2& value) const
     {
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        glUniform2fv(getUniformLocation(name), 1, &value[0]);
     }
     void setVec2(const std::string& name, float x, float y) const
     {
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+        glUniform2f(getUniformLocation(name), x, y);
+    }
+    void setVec2(UniformHandle handle, const glm::vec2& value) const
+    {
+        glUniform2fv(handle.location, 1, &value[0]);
     }
     // ------------------------------------------------------------------------
     void setVec3(const std::string& name, const glm::vec3& value) const
     {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        glUniform3fv(getUniformLocation(name), 1, &value[0]);
     }
     void setVec3(const std::string& name, float x, float y, float z) const
     {
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+        glUniform3f(getUniformLocation(name), x, y, z);
+    }
+    void setVec3(UniformHandle handle, const glm::vec3& value) const
+    {
+        glUniform3fv(handle.location, 1, &value[0]);
     }
     // ------------------------------------------------------------------------
     void setVec4(const std::string& name, const glm::vec4& value) const
     {
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        glUniform4fv(getUniformLocation(name), 1, &value[0]);
     }
     void setVec4(const std::string& name, float x, float y, float z, float w) const
     {
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+        glUniform4f(getUniformLocation(name), x, y, z, w);
+    }
+    void setVec4(UniformHandle handle, const glm::vec4& value) const
+    {
+        glUniform4fv(handle.location, 1, &value[0]);
     }
     // ------------------------------------------------------------------------
     void setMat2(const std::string& name, const glm::mat2& mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix2fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
+    }
+    void setMat2(UniformHandle handle, const glm::mat2& mat) const
+    {
+        glUniformMatrix2fv(handle.location, 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
     void setMat3(const std::string& name, const glm::mat3& mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
+    }
+    void setMat3(UniformHandle handle, const glm::mat3& mat) const
+    {
+        glUniformMatrix3fv(handle.location, 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
     void setMat4(const std::string& name, const glm::mat4& mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
+    }
+    void setMat4(UniformHandle handle, const glm::mat4& mat) const
+    {
+        glUniformMatrix4fv(handle.location, 1, GL_FALSE, &mat[0][0]);
     }
 
 private:
+    std::unordered_map<std::string, GLint> m_uniformLocations;
+
+    // queries every active uniform once after linking so lookups never hit the driver
+    // ------------------------------------------------------------------------
+    void reflectUniforms()
+    {
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::string buffer(maxLength > 0 ? maxLength : 1, '\0');
+        m_uniformLocations.reserve(count);
+        for (GLint i = 0; i < count; ++i)
+        {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(ID, (GLuint)i, maxLength, &length, &size, &type, &buffer[0]);
+            std::string name(buffer.data(), length);
+            GLint location = glGetUniformLocation(ID, name.c_str());
+            // uniforms inside blocks have no location
+            if (location < 0)
+                continue;
+            m_uniformLocations[name] = location;
+
+            // arrays of basic types are reported once as "name[0]"; register the
+            // bare name and every element so either spelling resolves
+            const std::string suffix = "[0]";
+            if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+            {
+                std::string base = name.substr(0, name.size() - suffix.size());
+                m_uniformLocations[base] = location;
+                for (GLint element = 1; element < size; ++element)
+                {
+                    std::string elementName = base + "[" + std::to_string(element) + "]";
+                    m_uniformLocations[elementName] = glGetUniformLocation(ID, elementName.c_str());
+                }
+            }
+        }
+    }
+    // rewrites the #version line and injects defines right after it
+    // ------------------------------------------------------------------------
+    static std::string applyOptions(const std::string& code, const ShaderOptions& options)
+    {
+        if (options.version.empty() && options.defines.empty())
+            return code;
+
+        std::string header;
+        std::string body = code;
+        size_t versionPos = code.find("#version");
+        if (versionPos != std::string::npos)
+        {
+            size_t lineEnd = code.find('\n', versionPos);
+            lineEnd = (lineEnd == std::string::npos) ? code.size() : lineEnd + 1;
+            header = code.substr(0, lineEnd);
+            body = code.substr(lineEnd);
+            if (!options.version.empty())
+                header = code.substr(0, versionPos) + "#version " + options.version + "\n";
+        }
+        else if (!options.version.empty())
+        {
+            header = "#version " + options.version + "\n";
+        }
+
+        for (const std::string& define : options.defines)
+            header += "#define " + define + "\n";
+        return header + body;
+    }
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
     void checkCompileErrors(GLuint shader, std::string type)
@@ -0,0 +1,56 @@
+/* ShaderBuffer.h */
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+
+#include "Shader.h"
+
+// How large arrays are exposed to shaders
+// ---------------------------------------
+enum class StorageBackend {
+    TextureBuffer,   // samplerBuffer/usamplerBuffer + texelFetch; core in GL 3.3
+    ShaderStorage,   // std430 buffer block; needs GL 4.3
+};
+
+// Best backend the current context supports
+StorageBackend preferredStorageBackend();
+// Shader variant matching a backend: SSBO builds as GLSL 4.30 with STORAGE_SSBO defined
+ShaderOptions shaderOptionsFor(StorageBackend backend);
+
+// Growable GPU array readable from shaders, backed by either a texture buffer
+// object or a shader storage buffer. The owner decides the data layout; for
+// texture buffers it is read back as texels of the given internal format.
+// -----------------------------------------------------------------------------
+class ShaderBuffer {
+public:
+    // binding is the SSBO binding point, or the texture unit for a texture buffer
+    void create(StorageBackend backend, GLenum texelFormat, unsigned int binding);
+    // Grow storage to hold at least bytes, up to maxBytes(); larger requests
+    // log an error once and stop at the limit, so callers must check
+    // capacity(). Returns true if the buffer was reallocated, in which case
+    // previous contents are gone and must be re-sent.
+    bool reserve(size_t bytes);
+    // Writes beyond capacity() are dropped
+    void update(size_t offset, size_t bytes, const void* data);
+    // Attach to the binding point / texture unit chosen at create()
+    void bind() const;
+    void release();
+
+    StorageBackend backend() const { return m_backend; }
+    size_t capacity() const { return m_capacity; }
+    // Largest size shaders can address: GL_MAX_TEXTURE_BUFFER_SIZE texels for
+    // texture buffers, GL_MAX_SHADER_STORAGE_BLOCK_SIZE bytes for SSBOs
+    size_t maxBytes() const;
+
+private:
+    GLenum target() const;
+
+    StorageBackend m_backend = StorageBackend::TextureBuffer;
+    GLenum         m_texelFormat = GL_RGBA32F;
+    unsigned int   m_binding = 0;
+    unsigned int   m_buffer = 0;
+    unsigned int   m_texture = 0;
+    size_t         m_capacity = 0;
+    bool           m_limitReported = false;
+};
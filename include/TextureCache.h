@@ -0,0 +1,50 @@
+/* TextureCache.h */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "TextureLoader.h"
+
+// Shared, reference-counted textures
+// ----------------------------------
+// acquire() returns the same GL texture for every request of one file with
+// the same decode options, so materials that share an image decode and store
+// it once. Textures whose last reference is released stay cached (most
+// recently used first) until the unused set exceeds its budget.
+class TextureCache {
+public:
+    explicit TextureCache(TextureLoader& loader, size_t maxUnused = 32);
+
+    // Texture for a file, loading it on first use; each call adds one reference
+    unsigned int acquire(const std::string& path, const TextureOptions& options = TextureOptions());
+    // Drop one reference taken by acquire()
+    void release(unsigned int texture);
+    // Delete unreferenced textures, oldest first, until at most keep remain
+    size_t evictUnused(size_t keep = 0);
+    // Delete every texture, referenced or not. Shut the loader down first so no
+    // upload targets a deleted name; call before the GL context is destroyed
+    void clear();
+
+    size_t size() const { return m_entries.size(); }
+    size_t unusedCount() const { return m_unused.size(); }
+
+private:
+    struct Entry {
+        unsigned int texture = 0;
+        uint32_t     references = 0;
+        std::list<std::string>::iterator unusedPosition;
+    };
+
+    static std::string makeKey(const std::string& path, const TextureOptions& options);
+
+    TextureLoader&                          m_loader;
+    size_t                                  m_maxUnused;
+    std::unordered_map<std::string, Entry>  m_entries;
+    std::unordered_map<unsigned int, std::string> m_keyByTexture;
+    // Unreferenced entries, most recently released at the front
+    std::list<std::string>                  m_unused;
+};
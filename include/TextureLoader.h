@@ -0,0 +1,112 @@
+/* TextureLoader.h */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "MipGenerator.h"
+
+class CookedTexture;
+
+// How a texture file is decoded and stored; part of its cache identity
+struct TextureOptions {
+    bool      srgb{ false };             // color data: store as sRGB so sampling linearizes it
+    bool      flipVertically{ false };   // first row at the bottom, as GL expects for most images
+    bool      normalMap{ false };        // renormalize mips; compresses to BC5
+    bool      compress{ false };         // BC1/BC3/BC5 when the context supports it
+    MipFilter mipFilter{ MipFilter::Box };
+
+    bool operator==(const TextureOptions& other) const
+    {
+        return srgb == other.srgb && flipVertically == other.flipVertically && normalMap == other.normalMap
+            && compress == other.compress && mipFilter == other.mipFilter;
+    }
+};
+
+// Asynchronous texture loading
+// ----------------------------
+// load() hands back a GL texture name right away, filled with a 1x1
+// placeholder. Worker threads read and decode the file in parallel and pass
+// the pixels to the GL thread through a bounded queue; processUploads() then
+// replaces the placeholder in place, so the returned name never changes.
+// Workers also build the mip chain (and block-compress it when requested), so
+// the GL thread only copies finished levels.
+// Images with a cooked copy (see tools/TextureCooker.cpp) skip decoding: the
+// .tex file is memory-mapped and its mip levels are uploaded directly. The
+// copy is only used if it was cooked with the requested options from the
+// current contents of the source; anything else decodes the source.
+class TextureLoader {
+public:
+    // workerCount 0 picks hardware threads - 1; maxDecoded bounds how many
+    // decoded images may wait for upload before workers block
+    explicit TextureLoader(unsigned int workerCount = 0, size_t maxDecoded = 4);
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    // GL thread only. Returns a usable texture immediately.
+    unsigned int load(const std::string& path, const TextureOptions& options = TextureOptions());
+    // Where load() looks for cooked copies: <sourceRoot>/<dir>/<name>.<ext> is
+    // cooked to <directory>/<dir>/<name>.<ext>.tex. An empty directory disables them.
+    void setCookedDirectory(const std::string& directory, const std::string& sourceRoot = "resources")
+    {
+        m_cookedDirectory = directory;
+        m_cookedSourceRoot = sourceRoot;
+    }
+    // GL thread only. Upload up to maxUploads finished images; returns how many
+    size_t processUploads(size_t maxUploads = (size_t)-1);
+    // GL thread only. Block, uploading as images arrive, until nothing is pending
+    void waitIdle();
+    // Requests not yet uploaded
+    size_t pending() const;
+    // True until the texture's real image has been uploaded (or failed)
+    bool isPending(unsigned int texture) const;
+    // Stop and join the workers; queued requests are dropped
+    void shutdown();
+
+private:
+    struct Request {
+        std::string    path;
+        unsigned int   texture;
+        TextureOptions options;
+        bool           compress;   // options.compress and the context supports the format
+    };
+
+    struct DecodedImage {
+        std::string           path;
+        unsigned int          texture;
+        uint32_t              internalFormat;   // GL enums
+        uint32_t              format;           // 0 when compressed
+        bool                  compressed;
+        std::vector<MipLevel> levels;      // empty when the load failed
+    };
+
+    std::string cookedPathFor(const std::string& path) const;
+    static bool uploadCooked(const CookedTexture& cooked, unsigned int texture);
+    void workerLoop();
+    static DecodedImage decode(const Request& request);
+    static void upload(const DecodedImage& image);
+
+    std::vector<std::thread> m_workers;
+    size_t                   m_maxDecoded;
+    std::string              m_cookedDirectory = "resources/cooked";
+    std::string              m_cookedSourceRoot = "resources";
+
+    mutable std::mutex       m_mutex;
+    std::condition_variable  m_requestReady;   // workers wait for requests
+    std::condition_variable  m_decodedSpace;   // workers wait for room in m_decoded
+    std::condition_variable  m_decodedReady;   // GL thread waits in waitIdle()
+    std::deque<Request>      m_requests;
+    std::deque<DecodedImage> m_decoded;
+    std::unordered_set<unsigned int> m_pendingTextures;
+    size_t                   m_outstanding = 0;
+    bool                     m_stopping = false;
+};
@@ -1,11 +1,21 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
+// per-instance model matrix (InstanceBuffer)
+layout (location = 3) in mat4 aModel;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+#ifdef QUANTIZED_POSITIONS
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+#endif
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+#ifdef QUANTIZED_POSITIONS
+    vec3 position = positionOffset + aPos * positionScale;
+#else
+    vec3 position = aPos;
+#endif
+    gl_Position = projection * view * aModel * vec4(position, 1.0);
 }
\ No newline at end of file
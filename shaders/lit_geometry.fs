@@ -4,8 +4,10 @@
 //                lit_geometry.fs
 // ----------------------------------------------------------------------------
 
-// maximum number of point lights your app will ever support
-#define MAX_POINT_LIGHTS 16
+// Point lights live in an unbounded array: a shader storage buffer when the
+// program is built with STORAGE_SSBO (GLSL 4.30), otherwise a texture buffer.
+// Lights are culled on the CPU into a froxel grid (ClusteredLighting), so each
+// fragment only loops over the lights whose influence reaches its cluster.
 
 // material properties
 struct Material {
@@ -15,6 +17,8 @@ struct Material {
 };
 
 // directional light data
+// (light structs live in a std140 block; each vec3 is paired with a scalar
+//  so the layout matches LightsBlockStd140 in LightingManager.h)
 struct DirLight {
     vec3 direction;
     vec3 ambient;
@@ -25,38 +29,112 @@ struct DirLight {
 // point light data
 struct PointLight {
     vec3  position;
-    vec3  ambient;
-    vec3  diffuse;
-    vec3  specular;
     float constant;
+    vec3  ambient;
     float linear;
+    vec3  diffuse;
     float quadratic;
+    vec3  specular;
 };
 
 // spotlight data
 struct SpotLight {
     vec3  position;
-    vec3  direction;
-    vec3  ambient;
-    vec3  diffuse;
-    vec3  specular;
     float constant;
+    vec3  direction;
     float linear;
+    vec3  ambient;
     float quadratic;
+    vec3  diffuse;
     float cutOff;
+    vec3  specular;
     float outerCutOff;
 };
 
+// per-frame light data, shared between shaders and uploaded in one buffer update
+layout(std140) uniform Lights {
+    DirLight   dirLight;
+    SpotLight  spotLight;
+    int        NR_POINT_LIGHTS;                // actual count at runtime
+    int        spotEnabled;                    // 0 when the spot light is culled
+};
+
+// froxel grid description, see ClustersBlockStd140
+layout(std140) uniform Clusters {
+    uvec4 clusterGrid;     // tiles x, tiles y, depth slices
+    vec4  clusterParams;   // slice scale, slice bias, viewport width, viewport height
+};
+
+#ifdef STORAGE_SSBO
+layout(std430, binding = 1) readonly buffer PointLights {
+    PointLight pointLights[];
+};
+
+layout(std430, binding = 2) readonly buffer ClusterCells {
+    uvec2 clusterCells[];          // offset, count into clusterLightIndices
+};
+
+layout(std430, binding = 3) readonly buffer ClusterLightIndices {
+    uint clusterLightIndices[];
+};
+
+PointLight FetchPointLight(int i)
+{
+    return pointLights[i];
+}
+
+uvec2 FetchClusterCell(uint cluster)
+{
+    return clusterCells[cluster];
+}
+
+uint FetchClusterLightIndex(uint i)
+{
+    return clusterLightIndices[i];
+}
+#else
+uniform usamplerBuffer clusterCells;          // RG32UI: offset, count
+uniform usamplerBuffer clusterLightIndices;   // R32UI
+
+uvec2 FetchClusterCell(uint cluster)
+{
+    return texelFetch(clusterCells, int(cluster)).xy;
+}
+
+uint FetchClusterLightIndex(uint i)
+{
+    return texelFetch(clusterLightIndices, int(i)).x;
+}
+
+// four RGBA32F texels per light, same layout as the struct above
+uniform samplerBuffer pointLightData;
+
+PointLight FetchPointLight(int i)
+{
+    vec4 t0 = texelFetch(pointLightData, i * 4 + 0);
+    vec4 t1 = texelFetch(pointLightData, i * 4 + 1);
+    vec4 t2 = texelFetch(pointLightData, i * 4 + 2);
+    vec4 t3 = texelFetch(pointLightData, i * 4 + 3);
+
+    PointLight light;
+    light.position  = t0.xyz;
+    light.constant  = t0.w;
+    light.ambient   = t1.xyz;
+    light.linear    = t1.w;
+    light.diffuse   = t2.xyz;
+    light.quadratic = t2.w;
+    light.specular  = t3.xyz;
+    return light;
+}
+#endif
+
 uniform Material material;
-uniform DirLight   dirLight;
-uniform int        NR_POINT_LIGHTS;                // actual count at runtime
-uniform PointLight pointLights[MAX_POINT_LIGHTS];   // fixed-size array
-uniform SpotLight  spotLight;
-uniform vec3       viewPos;
+uniform vec3     viewPos;
 
 in vec3  FragPos;
 in vec3  Normal;
 in vec2  TexCoords;
+in float ViewDepth;
 
 out vec4 FragColor;
 
@@ -124,6 +202,16 @@ vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
     return amb + dif + spc;
 }
 
+// ----------------------------------------------------------------------------
+uint ClusterIndex()
+{
+    float slice = log(max(ViewDepth, 1e-4)) * clusterParams.x + clusterParams.y;
+    uint z = min(uint(max(slice, 0.0)), clusterGrid.z - 1u);
+    uvec2 tile = uvec2(gl_FragCoord.xy / clusterParams.zw * vec2(clusterGrid.xy));
+    tile = min(tile, clusterGrid.xy - 1u);
+    return tile.x + clusterGrid.x * (tile.y + clusterGrid.y * z);
+}
+
 // ----------------------------------------------------------------------------
 void main()
 {
@@ -133,12 +221,14 @@ void main()
     // 1) directional
     vec3 result = CalcDirLight(dirLight, norm, viewDir);
 
-    // 2) point lights
-    for(int i = 0; i < NR_POINT_LIGHTS; ++i)
-        result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
+    // 2) point lights affecting this fragment's cluster
+    uvec2 cell = FetchClusterCell(ClusterIndex());
+    for(uint i = 0u; i < cell.y; ++i)
+        result += CalcPointLight(FetchPointLight(int(FetchClusterLightIndex(cell.x + i))), norm, FragPos, viewDir);
 
     // 3) spotlight
-    result += CalcSpotLight(spotLight, norm, FragPos, viewDir);
+    if (spotEnabled != 0)
+        result += CalcSpotLight(spotLight, norm, FragPos, viewDir);
 
     FragColor = vec4(result, 1.0);
 }
@@ -1,22 +1,61 @@
 #version 330 core
-layout(location = 0) in vec3 aPos;
+// Vertex attributes; their encoding follows the MeshBuffer's VertexFormat
+layout(location = 0) in vec3 aPos;          // QUANTIZED_POSITIONS: unorm16 within the mesh bounds
+#ifdef OCTAHEDRAL_NORMALS
+layout(location = 1) in vec2 aNormal;       // octahedral pair as raw snorm10 integers
+#else
 layout(location = 1) in vec3 aNormal;
+#endif
 layout(location = 2) in vec2 aTexCoords;
+// per-instance transforms (InstanceBuffer)
+layout(location = 3) in mat4 aModel;
+layout(location = 7) in mat3 aNormalMatrix;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
+out float ViewDepth;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+#ifdef QUANTIZED_POSITIONS
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+#endif
+
+#ifdef OCTAHEDRAL_NORMALS
+vec3 decodeOctahedral(vec2 packed)
+{
+    // c / 511 on every GL version, so axis-aligned normals decode exactly
+    vec2 e = clamp(packed / 511.0, -1.0, 1.0);
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+#endif
 
 void main()
 {
+#ifdef QUANTIZED_POSITIONS
+    vec3 position = positionOffset + aPos * positionScale;
+#else
+    vec3 position = aPos;
+#endif
+#ifdef OCTAHEDRAL_NORMALS
+    vec3 normal = decodeOctahedral(aNormal);
+#else
+    vec3 normal = aNormal;
+#endif
+
     // World-space position & normal
-    FragPos   = vec3(model * vec4(aPos, 1.0));
-    Normal    = mat3(transpose(inverse(model))) * aNormal;
+    FragPos   = vec3(aModel * vec4(position, 1.0));
+    Normal    = aNormalMatrix * normal;
     TexCoords = aTexCoords;
 
-    gl_Position = projection * view * vec4(FragPos, 1.0);
+    // Positive distance along the view axis, used to pick the light cluster slice
+    vec4 viewPos = view * vec4(FragPos, 1.0);
+    ViewDepth = -viewPos.z;
+
+    gl_Position = projection * viewPos;
 }
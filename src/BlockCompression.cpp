@@ -0,0 +1,248 @@
+/* BlockCompression.cpp */
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLOCK_COMPRESSION_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Below this many blocks the thread start-up costs more than it saves
+    const size_t MIN_BLOCKS_PER_THREAD = 256;
+
+    // Copy one 4x4 block of RGBA pixels, clamping reads at the image edge
+    void fetchBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, uint8_t* block)
+    {
+        for (uint32_t y = 0; y < 4; ++y) {
+            uint32_t sy = std::min(by * 4 + y, height - 1);
+            for (uint32_t x = 0; x < 4; ++x) {
+                uint32_t sx = std::min(bx * 4 + x, width - 1);
+                std::memcpy(block + (y * 4 + x) * 4, rgba + ((size_t)sy * width + sx) * 4, 4);
+            }
+        }
+    }
+
+    // Per-channel minimum and maximum over the 16 pixels
+    void blockBounds(const uint8_t* block, uint8_t* lo, uint8_t* hi)
+    {
+#ifdef BLOCK_COMPRESSION_SSE
+        __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+        __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16));
+        __m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 32));
+        __m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 48));
+        __m128i mn = _mm_min_epu8(_mm_min_epu8(r0, r1), _mm_min_epu8(r2, r3));
+        __m128i mx = _mm_max_epu8(_mm_max_epu8(r0, r1), _mm_max_epu8(r2, r3));
+        // Fold the four pixels of each register into one
+        mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(1, 0, 3, 2)));
+        mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(1, 0, 3, 2)));
+        mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(2, 3, 0, 1)));
+        mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(2, 3, 0, 1)));
+        int packedLo = _mm_cvtsi128_si32(mn);
+        int packedHi = _mm_cvtsi128_si32(mx);
+        std::memcpy(lo, &packedLo, 4);
+        std::memcpy(hi, &packedHi, 4);
+#else
+        for (int c = 0; c < 4; ++c) {
+            lo[c] = 255;
+            hi[c] = 0;
+        }
+        for (int i = 0; i < 16; ++i) {
+            for (int c = 0; c < 4; ++c) {
+                lo[c] = std::min(lo[c], block[i * 4 + c]);
+                hi[c] = std::max(hi[c], block[i * 4 + c]);
+            }
+        }
+#endif
+    }
+
+    uint16_t packRGB565(const uint8_t* c)
+    {
+        return (uint16_t)(((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+    }
+
+    void unpackRGB565(uint16_t v, int* c)
+    {
+        int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+        c[0] = (r << 3) | (r >> 2);
+        c[1] = (g << 2) | (g >> 4);
+        c[2] = (b << 3) | (b >> 2);
+    }
+
+    // Index (0..3) of the nearest palette color for each pixel
+    void selectColorIndices(const uint8_t* block, const int palette[4][3], uint32_t* indices)
+    {
+#ifdef BLOCK_COMPRESSION_SSE
+        // Four pixels per lane group; distances in float avoid 16-bit overflow
+        for (int group = 0; group < 4; ++group) {
+            const uint8_t* p = block + group * 16;
+            __m128 r = _mm_setr_ps(p[0], p[4], p[8], p[12]);
+            __m128 g = _mm_setr_ps(p[1], p[5], p[9], p[13]);
+            __m128 b = _mm_setr_ps(p[2], p[6], p[10], p[14]);
+
+            __m128 best = _mm_set1_ps(1e30f);
+            __m128i bestIndex = _mm_setzero_si128();
+            for (int k = 0; k < 4; ++k) {
+                __m128 dr = _mm_sub_ps(r, _mm_set1_ps((float)palette[k][0]));
+                __m128 dg = _mm_sub_ps(g, _mm_set1_ps((float)palette[k][1]));
+                __m128 db = _mm_sub_ps(b, _mm_set1_ps((float)palette[k][2]));
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+                __m128i closer = _mm_castps_si128(_mm_cmplt_ps(d, best));
+                best = _mm_min_ps(d, best);
+                bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(k)), _mm_andnot_si128(closer, bestIndex));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(indices + group * 4), bestIndex);
+        }
+#else
+        for (int i = 0; i < 16; ++i) {
+            const uint8_t* p = block + i * 4;
+            int bestDistance = 1 << 30;
+            for (uint32_t k = 0; k < 4; ++k) {
+                int dr = p[0] - palette[k][0], dg = p[1] - palette[k][1], db = p[2] - palette[k][2];
+                int d = dr * dr + dg * dg + db * db;
+                if (d < bestDistance) {
+                    bestDistance = d;
+                    indices[i] = k;
+                }
+            }
+        }
+#endif
+    }
+
+    // 8-byte BC1 color block from the RGB bounding box, inset by 1/16 of its
+    // extent so outliers do not stretch the palette
+    void encodeColorBlock(const uint8_t* block, uint8_t* out)
+    {
+        uint8_t lo[4], hi[4];
+        blockBounds(block, lo, hi);
+        for (int c = 0; c < 3; ++c) {
+            int inset = (hi[c] - lo[c]) >> 4;
+            lo[c] = (uint8_t)(lo[c] + inset);
+            hi[c] = (uint8_t)(hi[c] - inset);
+        }
+
+        uint16_t c0 = packRGB565(hi);
+        uint16_t c1 = packRGB565(lo);
+        uint32_t bits = 0;
+        if (c0 != c1) {
+            // c0 > c1 selects the four-color palette
+            if (c0 < c1)
+                std::swap(c0, c1);
+            int palette[4][3];
+            unpackRGB565(c0, palette[0]);
+            unpackRGB565(c1, palette[1]);
+            for (int c = 0; c < 3; ++c) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+            }
+            uint32_t indices[16];
+            selectColorIndices(block, palette, indices);
+            for (int i = 0; i < 16; ++i)
+                bits |= indices[i] << (i * 2);
+        }
+
+        out[0] = (uint8_t)(c0 & 0xFF);
+        out[1] = (uint8_t)(c0 >> 8);
+        out[2] = (uint8_t)(c1 & 0xFF);
+        out[3] = (uint8_t)(c1 >> 8);
+        std::memcpy(out + 4, &bits, 4);
+    }
+
+    // 8-byte BC4 block for one channel, eight-value mode with the exact range
+    void encodeChannelBlock(const uint8_t* block, int channel, uint8_t* out)
+    {
+        uint8_t lo[4], hi[4];
+        blockBounds(block, lo, hi);
+        int a0 = hi[channel];
+        int a1 = lo[channel];
+
+        uint64_t bits = 0;
+        if (a0 != a1) {
+            int range = a0 - a1;
+            for (int i = 0; i < 16; ++i) {
+                // Nearest of the 8 evenly spaced values, 0 = a1 .. 7 = a0
+                int t = ((block[i * 4 + channel] - a1) * 14 + range) / (2 * range);
+                uint64_t index = t == 7 ? 0 : (t == 0 ? 1 : (uint64_t)(8 - t));
+                bits |= index << (i * 3);
+            }
+        }
+
+        out[0] = (uint8_t)a0;
+        out[1] = (uint8_t)a1;
+        for (int i = 0; i < 6; ++i)
+            out[2 + i] = (uint8_t)(bits >> (i * 8));
+    }
+
+    void encodeBlock(BlockFormat format, const uint8_t* block, uint8_t* out)
+    {
+        switch (format) {
+        case BlockFormat::BC1:
+            encodeColorBlock(block, out);
+            break;
+        case BlockFormat::BC3:
+            encodeChannelBlock(block, 3, out);
+            encodeColorBlock(block, out + 8);
+            break;
+        case BlockFormat::BC5:
+            encodeChannelBlock(block, 0, out);
+            encodeChannelBlock(block, 1, out + 8);
+            break;
+        }
+    }
+
+    void compressRows(BlockFormat format, const uint8_t* rgba, uint32_t width, uint32_t height,
+                      uint32_t firstRow, uint32_t lastRow, uint8_t* out)
+    {
+        const uint32_t blocksX = (width + 3) / 4;
+        const size_t stride = blockBytes(format);
+        alignas(16) uint8_t block[64];
+        for (uint32_t by = firstRow; by < lastRow; ++by) {
+            for (uint32_t bx = 0; bx < blocksX; ++bx) {
+                fetchBlock(rgba, width, height, bx, by, block);
+                encodeBlock(format, block, out + ((size_t)by * blocksX + bx) * stride);
+            }
+        }
+    }
+}
+
+size_t blockBytes(BlockFormat format)
+{
+    return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+size_t compressedSize(BlockFormat format, uint32_t width, uint32_t height)
+{
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+}
+
+void compressBlocks(BlockFormat format, const uint8_t* rgba, uint32_t width, uint32_t height,
+                    uint8_t* out, unsigned int threadCount)
+{
+    if (width == 0 || height == 0)
+        return;
+
+    const uint32_t blockRows = (height + 3) / 4;
+    const size_t blockCount = (size_t)blockRows * ((width + 3) / 4);
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = (unsigned int)std::min<size_t>({ threadCount, blockRows, std::max<size_t>(1, blockCount / MIN_BLOCKS_PER_THREAD) });
+
+    if (threadCount <= 1) {
+        compressRows(format, rgba, width, height, 0, blockRows, out);
+        return;
+    }
+
+    // Blocks are independent, so each thread takes a contiguous band of rows
+    std::vector<std::thread> threads;
+    uint32_t rowsPerThread = (blockRows + threadCount - 1) / threadCount;
+    for (uint32_t first = 0; first < blockRows; first += rowsPerThread) {
+        uint32_t last = std::min(first + rowsPerThread, blockRows);
+        threads.emplace_back(compressRows, format, rgba, width, height, first, last, out);
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+}
@@ -0,0 +1,310 @@
+/* Bvh.cpp */
+#include "Bvh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+    const int      SAH_BINS = 16;
+    const uint32_t MAX_LEAF_SIZE = 8;
+    // Cost of visiting a node relative to testing one object
+    const float    TRAVERSAL_COST = 1.0f;
+}
+
+void Bvh::build(const Aabb* bounds, size_t count)
+{
+    clear();
+    if (count == 0)
+        return;
+
+    m_objects.resize(count);
+    m_objectBounds.assign(bounds, bounds + count);
+    std::vector<glm::vec3> centroids(count);
+    Aabb root;
+    for (size_t i = 0; i < count; ++i) {
+        m_objects[i] = (uint32_t)i;
+        centroids[i] = bounds[i].center();
+        root.grow(bounds[i]);
+    }
+
+    m_nodes.reserve(2 * count);
+    m_nodes.push_back(Node{ root, 0, (uint32_t)count });
+    // Children are always appended after their parent, which refit relies on
+    std::vector<uint32_t> stack(1, 0u);
+    while (!stack.empty()) {
+        uint32_t nodeIndex = stack.back();
+        stack.pop_back();
+        split(nodeIndex, centroids);
+        if (m_nodes[nodeIndex].count == 0) {
+            stack.push_back(m_nodes[nodeIndex].first);
+            stack.push_back(m_nodes[nodeIndex].first + 1);
+        }
+    }
+    m_cost = m_builtCost = computeCost();
+}
+
+void Bvh::split(uint32_t nodeIndex, std::vector<glm::vec3>& centroids)
+{
+    const uint32_t first = m_nodes[nodeIndex].first;
+    const uint32_t count = m_nodes[nodeIndex].count;
+    const float nodeArea = m_nodes[nodeIndex].bounds.surfaceArea();
+    if (count <= 2)
+        return;
+
+    Aabb centroidBounds;
+    for (uint32_t i = first; i < first + count; ++i)
+        centroidBounds.grow(centroids[i]);
+
+    // Binned SAH: cost of a leaf is one test per object
+    float bestCost = std::numeric_limits<float>::max();
+    int bestAxis = -1, bestBin = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        float lo = centroidBounds.min[axis], hi = centroidBounds.max[axis];
+        if (hi - lo <= 1e-12f)
+            continue;
+        float scale = SAH_BINS / (hi - lo);
+
+        Aabb binBounds[SAH_BINS];
+        uint32_t binCount[SAH_BINS] = {};
+        for (uint32_t i = first; i < first + count; ++i) {
+            int bin = std::min(SAH_BINS - 1, (int)((centroids[i][axis] - lo) * scale));
+            binBounds[bin].grow(m_objectBounds[i]);
+            ++binCount[bin];
+        }
+
+        // Sweep from the right, then evaluate each split from the left
+        float rightArea[SAH_BINS];
+        uint32_t rightCount[SAH_BINS];
+        Aabb accumulated;
+        uint32_t accumulatedCount = 0;
+        for (int b = SAH_BINS - 1; b > 0; --b) {
+            accumulated.grow(binBounds[b]);
+            accumulatedCount += binCount[b];
+            rightArea[b] = accumulated.surfaceArea();
+            rightCount[b] = accumulatedCount;
+        }
+        accumulated = Aabb();
+        accumulatedCount = 0;
+        for (int b = 0; b < SAH_BINS - 1; ++b) {
+            accumulated.grow(binBounds[b]);
+            accumulatedCount += binCount[b];
+            if (accumulatedCount == 0 || rightCount[b + 1] == 0)
+                continue;
+            float cost = TRAVERSAL_COST
+                + (accumulated.surfaceArea() * accumulatedCount + rightArea[b + 1] * rightCount[b + 1]) / nodeArea;
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = b;
+            }
+        }
+    }
+
+    // Stay a leaf when splitting cannot beat testing these few objects directly;
+    // larger nodes split regardless so leaves stay bounded
+    if (count <= MAX_LEAF_SIZE && (bestAxis < 0 || bestCost >= (float)count))
+        return;
+
+    uint32_t mid = first + count / 2;
+    if (bestAxis >= 0) {
+        float lo = centroidBounds.min[bestAxis];
+        float scale = SAH_BINS / (centroidBounds.max[bestAxis] - lo);
+        uint32_t left = first;
+        for (uint32_t i = first; i < first + count; ++i) {
+            int bin = std::min(SAH_BINS - 1, (int)((centroids[i][bestAxis] - lo) * scale));
+            if (bin <= bestBin) {
+                std::swap(m_objects[i], m_objects[left]);
+                std::swap(m_objectBounds[i], m_objectBounds[left]);
+                std::swap(centroids[i], centroids[left]);
+                ++left;
+            }
+        }
+        mid = left;
+    }
+    // Without a split position (coincident centroids) the range is halved
+
+    Node leftNode{ Aabb(), first, mid - first };
+    Node rightNode{ Aabb(), mid, first + count - mid };
+    for (uint32_t i = leftNode.first; i < leftNode.first + leftNode.count; ++i)
+        leftNode.bounds.grow(m_objectBounds[i]);
+    for (uint32_t i = rightNode.first; i < rightNode.first + rightNode.count; ++i)
+        rightNode.bounds.grow(m_objectBounds[i]);
+
+    m_nodes[nodeIndex].first = (uint32_t)m_nodes.size();
+    m_nodes[nodeIndex].count = 0;
+    m_nodes.push_back(leftNode);
+    m_nodes.push_back(rightNode);
+}
+
+void Bvh::refit(const Aabb* bounds)
+{
+    for (size_t i = 0; i < m_objects.size(); ++i)
+        m_objectBounds[i] = bounds[m_objects[i]];
+
+    for (size_t n = m_nodes.size(); n-- > 0;) {
+        Node& node = m_nodes[n];
+        node.bounds = Aabb();
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i)
+                node.bounds.grow(m_objectBounds[i]);
+        }
+        else {
+            node.bounds.grow(m_nodes[node.first].bounds);
+            node.bounds.grow(m_nodes[node.first + 1].bounds);
+        }
+    }
+    m_cost = computeCost();
+}
+
+void Bvh::clear()
+{
+    m_nodes.clear();
+    m_objects.clear();
+    m_objectBounds.clear();
+    m_cost = m_builtCost = 0.0f;
+}
+
+float Bvh::computeCost() const
+{
+    if (m_nodes.empty())
+        return 0.0f;
+    float rootArea = m_nodes[0].bounds.surfaceArea();
+    if (rootArea <= 0.0f)
+        return (float)m_objects.size();
+    float cost = 0.0f;
+    for (const Node& node : m_nodes)
+        cost += node.bounds.surfaceArea() * (node.count > 0 ? (float)node.count : TRAVERSAL_COST);
+    return cost / rootArea;
+}
+
+void Bvh::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& objects) const
+{
+    objects.clear();
+    m_candidates.clear();
+    m_candidateObjects.clear();
+    if (m_nodes.empty())
+        return;
+
+    // Each entry carries the planes its parent was not already fully inside of
+    const unsigned int ALL_PLANES = (1u << Frustum::PLANE_COUNT) - 1;
+    std::vector<std::pair<uint32_t, unsigned int>> stack;
+    stack.reserve(64);
+    stack.push_back({ 0u, ALL_PLANES });
+
+    while (!stack.empty()) {
+        std::pair<uint32_t, unsigned int> entry = stack.back();
+        stack.pop_back();
+        const Node& node = m_nodes[entry.first];
+        unsigned int mask = entry.second;
+        if (frustum.classifyBox(node.bounds.center(), node.bounds.extent(), mask) == Frustum::SIDE_OUTSIDE)
+            continue;
+
+        // Leaves fully inside are taken whole; the objects of straddling
+        // leaves are gathered and tested in one batch below
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                if (mask == 0) {
+                    objects.push_back(m_objects[i]);
+                    continue;
+                }
+                m_candidates.push(m_objectBounds[i].min, m_objectBounds[i].max);
+                m_candidateObjects.push_back(m_objects[i]);
+            }
+            continue;
+        }
+        stack.push_back({ node.first, mask });
+        stack.push_back({ node.first + 1, mask });
+    }
+
+    cullAabbs(frustum, m_candidates, m_candidateVisible);
+    for (uint32_t candidate : m_candidateVisible)
+        objects.push_back(m_candidateObjects[candidate]);
+}
+
+void Bvh::querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& objects) const
+{
+    objects.clear();
+    if (m_nodes.empty())
+        return;
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(0u);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (!node.bounds.intersectsSphere(center, radius))
+            continue;
+
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                if (m_objectBounds[i].intersectsSphere(center, radius))
+                    objects.push_back(m_objects[i]);
+            }
+            continue;
+        }
+        stack.push_back(node.first);
+        stack.push_back(node.first + 1);
+    }
+}
+
+bool Bvh::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                  uint32_t& object, float& distance) const
+{
+    if (m_nodes.empty())
+        return false;
+
+    // Keep the slab math finite for axis-parallel rays
+    glm::vec3 invDirection;
+    for (int a = 0; a < 3; ++a)
+        invDirection[a] = 1.0f / (std::abs(direction[a]) > 1e-12f ? direction[a] : 1e-12f);
+
+    float best = maxDistance;
+    bool hit = false;
+    float tRoot;
+    if (!m_nodes[0].bounds.intersectsRay(origin, invDirection, best, tRoot))
+        return false;
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(0u);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                float t;
+                if (m_objectBounds[i].intersectsRay(origin, invDirection, best, t) && (!hit || t < best)) {
+                    best = t;
+                    object = m_objects[i];
+                    hit = true;
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearer child first by pushing it last
+        uint32_t a = node.first, b = node.first + 1;
+        float ta, tb;
+        bool hitA = m_nodes[a].bounds.intersectsRay(origin, invDirection, best, ta);
+        bool hitB = m_nodes[b].bounds.intersectsRay(origin, invDirection, best, tb);
+        if (hitA && hitB) {
+            if (ta < tb)
+                std::swap(a, b);
+            stack.push_back(a);
+            stack.push_back(b);
+        }
+        else if (hitA) {
+            stack.push_back(a);
+        }
+        else if (hitB) {
+            stack.push_back(b);
+        }
+    }
+    if (hit)
+        distance = best;
+    return hit;
+}
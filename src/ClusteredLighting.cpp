@@ -0,0 +1,216 @@
+/* ClusteredLighting.cpp */
+#include "ClusteredLighting.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    bool sphereIntersectsBox(const glm::vec3& center, float radiusSq, const glm::vec3& bmin, const glm::vec3& bmax)
+    {
+        glm::vec3 closest = glm::clamp(center, bmin, bmax);
+        glm::vec3 d = center - closest;
+        return glm::dot(d, d) <= radiusSq;
+    }
+
+    int clampInt(int v, int lo, int hi)
+    {
+        return std::max(lo, std::min(v, hi));
+    }
+}
+
+//------------------------------------------------------------------------------
+// ClusteredLighting
+ClusteredLighting::ClusteredLighting(StorageBackend backend, const ClusterGridDesc& grid)
+    : m_grid(grid)
+{
+    bool ssbo = backend == StorageBackend::ShaderStorage;
+    m_cellStorage.create(backend, GL_RG32UI, ssbo ? CELLS_SSBO_BINDING : CELLS_TEXTURE_UNIT);
+    m_indexStorage.create(backend, GL_R32UI, ssbo ? INDICES_SSBO_BINDING : INDICES_TEXTURE_UNIT);
+
+    glGenBuffers(1, &m_ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(ClustersBlockStd140), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, CLUSTERS_BINDING, m_ubo);
+}
+
+void ClusteredLighting::bindToShader(const Shader& shader) const
+{
+    unsigned int blockIndex = glGetUniformBlockIndex(shader.ID, "Clusters");
+    if (blockIndex != GL_INVALID_INDEX)
+        glUniformBlockBinding(shader.ID, blockIndex, CLUSTERS_BINDING);
+
+    // SSBO bindings are fixed in the shader; texture buffers need their samplers set
+    if (m_cellStorage.backend() == StorageBackend::TextureBuffer) {
+        shader.use();
+        shader.setInt("clusterCells", (int)CELLS_TEXTURE_UNIT);
+        shader.setInt("clusterLightIndices", (int)INDICES_TEXTURE_UNIT);
+    }
+}
+
+void ClusteredLighting::rebuildBounds(float fovY, float aspect, float zNear, float zFar)
+{
+    m_tanHalfFovY = std::tan(fovY * 0.5f);
+    m_aspect = aspect;
+
+    // Exponential slicing keeps froxels roughly cubic: slice = log(depth) * scale + bias
+    float logRatio = std::log(zFar / zNear);
+    m_sliceScale = (float)m_grid.slicesZ / logRatio;
+    m_sliceBias = -(float)m_grid.slicesZ * std::log(zNear) / logRatio;
+
+    const float tanX = m_tanHalfFovY * aspect;
+    const float tanY = m_tanHalfFovY;
+    m_bounds.resize((size_t)m_grid.tilesX * m_grid.tilesY * m_grid.slicesZ);
+
+    size_t index = 0;
+    for (unsigned int z = 0; z < m_grid.slicesZ; ++z) {
+        float nearDepth = zNear * std::pow(zFar / zNear, (float)z / m_grid.slicesZ);
+        float farDepth = zNear * std::pow(zFar / zNear, (float)(z + 1) / m_grid.slicesZ);
+        for (unsigned int y = 0; y < m_grid.tilesY; ++y) {
+            float ndcY0 = -1.0f + 2.0f * y / m_grid.tilesY;
+            float ndcY1 = -1.0f + 2.0f * (y + 1) / m_grid.tilesY;
+            for (unsigned int x = 0; x < m_grid.tilesX; ++x, ++index) {
+                float ndcX0 = -1.0f + 2.0f * x / m_grid.tilesX;
+                float ndcX1 = -1.0f + 2.0f * (x + 1) / m_grid.tilesX;
+
+                // The tile's side planes pass through the eye, so the extremes
+                // sit on the near or far slice plane
+                glm::vec3 bmin(1e30f), bmax(-1e30f);
+                for (float depth : { nearDepth, farDepth }) {
+                    for (float ndcX : { ndcX0, ndcX1 }) {
+                        for (float ndcY : { ndcY0, ndcY1 }) {
+                            glm::vec3 p(ndcX * tanX * depth, ndcY * tanY * depth, -depth);
+                            bmin = glm::min(bmin, p);
+                            bmax = glm::max(bmax, p);
+                        }
+                    }
+                }
+                m_bounds[index] = ClusterBounds{ bmin, bmax };
+            }
+        }
+    }
+}
+
+unsigned int ClusteredLighting::sliceForDepth(float depth) const
+{
+    int slice = (int)std::floor(std::log(depth) * m_sliceScale + m_sliceBias);
+    return (unsigned int)clampInt(slice, 0, (int)m_grid.slicesZ - 1);
+}
+
+void ClusteredLighting::update(const Camera& camera, int viewportWidth, int viewportHeight, const LightingManager& lighting)
+{
+    if (viewportWidth <= 0 || viewportHeight <= 0)
+        return;
+
+    float aspect = (float)viewportWidth / (float)viewportHeight;
+    glm::vec4 key(camera.Zoom, aspect, camera.NearPlane, camera.FarPlane);
+    if (key != m_projectionKey || m_bounds.empty()) {
+        rebuildBounds(glm::radians(camera.Zoom), aspect, camera.NearPlane, camera.FarPlane);
+        m_projectionKey = key;
+    }
+
+    const size_t clusterCount = m_bounds.size();
+    const float zNear = camera.NearPlane;
+    const float zFar = camera.FarPlane;
+    const float tanX = m_tanHalfFovY * m_aspect;
+    const float tanY = m_tanHalfFovY;
+    const glm::mat4 view = camera.GetViewMatrix();
+    const PointLightPool& points = lighting.pointLights();
+    const std::vector<uint8_t>& visible = lighting.pointVisibility();
+
+    // 1) Gather (cluster, light) pairs for lights that survived frustum culling;
+    // lights that did not fit in the point storage cannot be indexed
+    const size_t pointCount = lighting.residentPointCount();
+    m_pairCluster.clear();
+    m_pairLight.clear();
+    for (size_t i = 0; i < pointCount; ++i) {
+        float radius = points.radius[i];
+        if (!visible[i] || radius <= 0.0f)
+            continue;
+
+        glm::vec3 center = glm::vec3(view * glm::vec4(points.position[i], 1.0f));
+        float depth = -center.z;
+        float minDepth = std::max(depth - radius, zNear);
+        float maxDepth = std::min(depth + radius, zFar);
+        if (minDepth > maxDepth)
+            continue;
+
+        // Conservative screen rectangle of the sphere's view-space box over its depth range
+        float ndcMinX = std::min((center.x - radius) / minDepth, (center.x - radius) / maxDepth) / tanX;
+        float ndcMaxX = std::max((center.x + radius) / minDepth, (center.x + radius) / maxDepth) / tanX;
+        float ndcMinY = std::min((center.y - radius) / minDepth, (center.y - radius) / maxDepth) / tanY;
+        float ndcMaxY = std::max((center.y + radius) / minDepth, (center.y + radius) / maxDepth) / tanY;
+        if (ndcMinX > 1.0f || ndcMaxX < -1.0f || ndcMinY > 1.0f || ndcMaxY < -1.0f)
+            continue;
+
+        int x0 = clampInt((int)std::floor((ndcMinX * 0.5f + 0.5f) * m_grid.tilesX), 0, (int)m_grid.tilesX - 1);
+        int x1 = clampInt((int)std::floor((ndcMaxX * 0.5f + 0.5f) * m_grid.tilesX), 0, (int)m_grid.tilesX - 1);
+        int y0 = clampInt((int)std::floor((ndcMinY * 0.5f + 0.5f) * m_grid.tilesY), 0, (int)m_grid.tilesY - 1);
+        int y1 = clampInt((int)std::floor((ndcMaxY * 0.5f + 0.5f) * m_grid.tilesY), 0, (int)m_grid.tilesY - 1);
+        unsigned int z0 = sliceForDepth(minDepth);
+        unsigned int z1 = sliceForDepth(maxDepth);
+
+        // 2) Exact sphere vs froxel test inside the candidate range
+        float radiusSq = radius * radius;
+        for (unsigned int z = z0; z <= z1; ++z) {
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    size_t cluster = x + m_grid.tilesX * (y + (size_t)m_grid.tilesY * z);
+                    const ClusterBounds& b = m_bounds[cluster];
+                    if (sphereIntersectsBox(center, radiusSq, b.min, b.max)) {
+                        m_pairCluster.push_back((uint32_t)cluster);
+                        m_pairLight.push_back((uint32_t)i);
+                    }
+                }
+            }
+        }
+    }
+
+    // 3) Counting sort the pairs into compact per-cluster lists
+    m_cells.assign(clusterCount, glm::uvec2(0));
+    for (uint32_t cluster : m_pairCluster)
+        ++m_cells[cluster].y;
+    uint32_t offset = 0;
+    for (glm::uvec2& cell : m_cells) {
+        cell.x = offset;
+        offset += cell.y;
+        cell.y = 0;
+    }
+    m_lightIndices.resize(m_pairLight.size());
+    for (size_t p = 0; p < m_pairLight.size(); ++p) {
+        glm::uvec2& cell = m_cells[m_pairCluster[p]];
+        m_lightIndices[cell.x + cell.y++] = m_pairLight[p];
+    }
+
+    // 4) Upload grid parameters, cells and the index list
+    m_block.grid = glm::uvec4(m_grid.tilesX, m_grid.tilesY, m_grid.slicesZ, 0u);
+    m_block.params = glm::vec4(m_sliceScale, m_sliceBias, (float)viewportWidth, (float)viewportHeight);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ClustersBlockStd140), &m_block);
+
+    if (!m_lightIndices.empty()) {
+        m_indexStorage.reserve(m_lightIndices.size() * sizeof(uint32_t));
+        m_indexStorage.update(0, m_lightIndices.size() * sizeof(uint32_t), m_lightIndices.data());
+        // If the index list hit the storage limit, trim each cell to the part that made it
+        const uint32_t resident = (uint32_t)(m_indexStorage.capacity() / sizeof(uint32_t));
+        if (m_lightIndices.size() > resident) {
+            for (glm::uvec2& cell : m_cells)
+                cell.y = cell.x >= resident ? 0u : std::min(cell.y, resident - cell.x);
+        }
+    }
+    else {
+        m_indexStorage.reserve(sizeof(uint32_t));
+    }
+    m_cellStorage.reserve(m_cells.size() * sizeof(glm::uvec2));
+    m_cellStorage.update(0, m_cells.size() * sizeof(glm::uvec2), m_cells.data());
+}
+
+void ClusteredLighting::release()
+{
+    if (m_ubo != 0) {
+        glDeleteBuffers(1, &m_ubo);
+        m_ubo = 0;
+    }
+    m_cellStorage.release();
+    m_indexStorage.release();
+}
@@ -0,0 +1,71 @@
+/* CookedTexture.cpp */
+#include "CookedTexture.h"
+
+#include <fstream>
+
+namespace {
+    const uint64_t LEVEL_ALIGNMENT = 16;
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+bool writeCookedTexture(const std::string& path, CookedTextureHeader header, const std::vector<CookedLevel>& levels)
+{
+    header.magic = CookedTextureHeader::MAGIC;
+    header.version = CookedTextureHeader::VERSION;
+    header.levelCount = (uint32_t)levels.size();
+
+    std::vector<CookedLevelDesc> descs(levels.size());
+    uint64_t offset = sizeof(CookedTextureHeader) + levels.size() * sizeof(CookedLevelDesc);
+    for (size_t i = 0; i < levels.size(); ++i) {
+        offset = alignUp(offset, LEVEL_ALIGNMENT);
+        descs[i] = CookedLevelDesc{ levels[i].width, levels[i].height, offset, levels[i].data.size() };
+        offset += levels[i].data.size();
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return false;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(descs.data()), descs.size() * sizeof(CookedLevelDesc));
+
+    uint64_t written = sizeof(CookedTextureHeader) + descs.size() * sizeof(CookedLevelDesc);
+    const char padding[LEVEL_ALIGNMENT] = {};
+    for (size_t i = 0; i < levels.size(); ++i) {
+        out.write(padding, (std::streamsize)(descs[i].offset - written));
+        out.write(reinterpret_cast<const char*>(levels[i].data.data()), levels[i].data.size());
+        written = descs[i].offset + descs[i].size;
+    }
+    return (bool)out;
+}
+
+bool CookedTexture::open(const std::string& path)
+{
+    m_header = nullptr;
+    m_levels = nullptr;
+    if (!m_file.open(path) || m_file.size() < sizeof(CookedTextureHeader))
+        return false;
+
+    const CookedTextureHeader* header = reinterpret_cast<const CookedTextureHeader*>(m_file.data());
+    if (header->magic != CookedTextureHeader::MAGIC || header->version != CookedTextureHeader::VERSION
+        || header->levelCount == 0)
+        return false;
+
+    uint64_t tableEnd = sizeof(CookedTextureHeader) + (uint64_t)header->levelCount * sizeof(CookedLevelDesc);
+    if (tableEnd > m_file.size())
+        return false;
+
+    // Reject truncated files before GL reads past the mapping
+    const CookedLevelDesc* levels = reinterpret_cast<const CookedLevelDesc*>(m_file.data() + sizeof(CookedTextureHeader));
+    for (uint32_t i = 0; i < header->levelCount; ++i) {
+        if (levels[i].offset < tableEnd || levels[i].offset + levels[i].size > m_file.size())
+            return false;
+    }
+
+    m_header = header;
+    m_levels = levels;
+    return true;
+}
@@ -0,0 +1,32 @@
+/* CpuFeatures.cpp */
+#include "CpuFeatures.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace {
+    bool detectAvx()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        // The OS must also save the YMM registers across context switches
+        return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx") != 0;
+#else
+        return false;
+#endif
+    }
+}
+
+bool cpuSupportsAvx()
+{
+    static const bool supported = detectAvx();
+    return supported;
+}
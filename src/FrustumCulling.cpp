@@ -0,0 +1,165 @@
+/* FrustumCulling.cpp */
+#include "FrustumCulling.h"
+#include "CpuFeatures.h"
+#include "FrustumCullingAvx.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_CULLING_SSE 1
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+    // The AVX kernels read the planes as a flat xyzw array
+    static_assert(sizeof(Frustum::planes) == Frustum::PLANE_COUNT * 4 * sizeof(float), "planes must be tightly packed");
+
+    inline unsigned int lowestBit(unsigned int mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (unsigned int)index;
+#else
+        return (unsigned int)__builtin_ctz(mask);
+#endif
+    }
+
+    // Append base + i for every set bit i of a lane mask
+    inline size_t emitVisible(unsigned int mask, uint32_t base, uint32_t* out)
+    {
+        size_t n = 0;
+        while (mask) {
+            out[n++] = base + lowestBit(mask);
+            mask &= mask - 1;
+        }
+        return n;
+    }
+
+    // Signed distance plus the object's reach toward the plane: >= 0 means
+    // the object is at least partly on the inner side
+    inline bool sphereInside(const Frustum& f, float x, float y, float z, float r)
+    {
+        for (const glm::vec4& p : f.planes) {
+            // Same association as the SIMD lanes so every path agrees bit for bit
+            if ((p.x * x + p.y * y) + (p.z * z + (p.w + r)) < 0.0f)
+                return false;
+        }
+        return true;
+    }
+
+    inline bool aabbInside(const Frustum& f, float cx, float cy, float cz, float ex, float ey, float ez)
+    {
+        for (const glm::vec4& p : f.planes) {
+            float reach = (std::abs(p.x) * ex + std::abs(p.y) * ey) + std::abs(p.z) * ez;
+            if (((p.x * cx + p.y * cy) + (p.z * cz + p.w)) + reach < 0.0f)
+                return false;
+        }
+        return true;
+    }
+}
+
+size_t cullSpheres(const Frustum& frustum, const SphereBoundsSoA& spheres, std::vector<uint32_t>& visible)
+{
+    const size_t count = spheres.size();
+    const float* xs = spheres.x.data();
+    const float* ys = spheres.y.data();
+    const float* zs = spheres.z.data();
+    const float* rs = spheres.radius.data();
+    visible.resize(count);
+    uint32_t* out = visible.data();
+    size_t n = 0, i = 0;
+
+    // Eight at a time where the CPU has AVX; SSE and scalar take the rest
+    if (cpuSupportsAvx())
+        n = cullSpheresAvx(&frustum.planes[0].x, Frustum::PLANE_COUNT, xs, ys, zs, rs, count, out, i);
+#ifdef FRUSTUM_CULLING_SSE
+    {
+        __m128 px[Frustum::PLANE_COUNT], py[Frustum::PLANE_COUNT], pz[Frustum::PLANE_COUNT], pw[Frustum::PLANE_COUNT];
+        for (int p = 0; p < Frustum::PLANE_COUNT; ++p) {
+            px[p] = _mm_set1_ps(frustum.planes[p].x);
+            py[p] = _mm_set1_ps(frustum.planes[p].y);
+            pz[p] = _mm_set1_ps(frustum.planes[p].z);
+            pw[p] = _mm_set1_ps(frustum.planes[p].w);
+        }
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            __m128 x = _mm_loadu_ps(xs + i), y = _mm_loadu_ps(ys + i);
+            __m128 z = _mm_loadu_ps(zs + i), r = _mm_loadu_ps(rs + i);
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < Frustum::PLANE_COUNT; ++p) {
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[p], x), _mm_mul_ps(py[p], y)),
+                                      _mm_add_ps(_mm_mul_ps(pz[p], z), _mm_add_ps(pw[p], r)));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(d, zero));
+            }
+            n += emitVisible((unsigned int)_mm_movemask_ps(inside), (uint32_t)i, out + n);
+        }
+    }
+#endif
+
+    // Scalar tail, or everything without SSE
+    for (; i < count; ++i) {
+        if (sphereInside(frustum, xs[i], ys[i], zs[i], rs[i]))
+            out[n++] = (uint32_t)i;
+    }
+    visible.resize(n);
+    return n;
+}
+
+size_t cullAabbs(const Frustum& frustum, const AabbBoundsSoA& boxes, std::vector<uint32_t>& visible)
+{
+    const size_t count = boxes.size();
+    const float* cxs = boxes.centerX.data();
+    const float* cys = boxes.centerY.data();
+    const float* czs = boxes.centerZ.data();
+    const float* exs = boxes.extentX.data();
+    const float* eys = boxes.extentY.data();
+    const float* ezs = boxes.extentZ.data();
+    visible.resize(count);
+    uint32_t* out = visible.data();
+    size_t n = 0, i = 0;
+
+    // A box reaches toward a plane by its extent projected on |normal|
+    if (cpuSupportsAvx())
+        n = cullAabbsAvx(&frustum.planes[0].x, Frustum::PLANE_COUNT, cxs, cys, czs, exs, eys, ezs, count, out, i);
+#ifdef FRUSTUM_CULLING_SSE
+    {
+        __m128 px[Frustum::PLANE_COUNT], py[Frustum::PLANE_COUNT], pz[Frustum::PLANE_COUNT], pw[Frustum::PLANE_COUNT];
+        __m128 ax[Frustum::PLANE_COUNT], ay[Frustum::PLANE_COUNT], az[Frustum::PLANE_COUNT];
+        for (int p = 0; p < Frustum::PLANE_COUNT; ++p) {
+            const glm::vec4& plane = frustum.planes[p];
+            px[p] = _mm_set1_ps(plane.x);
+            py[p] = _mm_set1_ps(plane.y);
+            pz[p] = _mm_set1_ps(plane.z);
+            pw[p] = _mm_set1_ps(plane.w);
+            ax[p] = _mm_set1_ps(std::abs(plane.x));
+            ay[p] = _mm_set1_ps(std::abs(plane.y));
+            az[p] = _mm_set1_ps(std::abs(plane.z));
+        }
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            __m128 cx = _mm_loadu_ps(cxs + i), cy = _mm_loadu_ps(cys + i), cz = _mm_loadu_ps(czs + i);
+            __m128 ex = _mm_loadu_ps(exs + i), ey = _mm_loadu_ps(eys + i), ez = _mm_loadu_ps(ezs + i);
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < Frustum::PLANE_COUNT; ++p) {
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[p], cx), _mm_mul_ps(py[p], cy)),
+                                      _mm_add_ps(_mm_mul_ps(pz[p], cz), pw[p]));
+                __m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey)),
+                                          _mm_mul_ps(az[p], ez));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(d, reach), zero));
+            }
+            n += emitVisible((unsigned int)_mm_movemask_ps(inside), (uint32_t)i, out + n);
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        if (aabbInside(frustum, cxs[i], cys[i], czs[i], exs[i], eys[i], ezs[i]))
+            out[n++] = (uint32_t)i;
+    }
+    visible.resize(n);
+    return n;
+}
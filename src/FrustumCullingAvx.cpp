@@ -0,0 +1,115 @@
+/* FrustumCullingAvx.cpp */
+// Compiled with AVX enabled (see CMakeLists.txt); keep shared headers out
+#include "FrustumCullingAvx.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+    // Frustum::PLANE_COUNT, with room to spare
+    const int MAX_PLANES = 8;
+
+    inline unsigned int lowestBit(unsigned int mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (unsigned int)index;
+#else
+        return (unsigned int)__builtin_ctz(mask);
+#endif
+    }
+
+    inline size_t emitVisible(unsigned int mask, uint32_t base, uint32_t* out)
+    {
+        size_t n = 0;
+        while (mask) {
+            out[n++] = base + lowestBit(mask);
+            mask &= mask - 1;
+        }
+        return n;
+    }
+}
+
+size_t cullSpheresAvx(const float* planes, int planeCount, const float* xs, const float* ys, const float* zs,
+                      const float* rs, size_t count, uint32_t* out, size_t& processed)
+{
+    __m256 px[MAX_PLANES], py[MAX_PLANES], pz[MAX_PLANES], pw[MAX_PLANES];
+    for (int p = 0; p < planeCount; ++p) {
+        px[p] = _mm256_set1_ps(planes[p * 4 + 0]);
+        py[p] = _mm256_set1_ps(planes[p * 4 + 1]);
+        pz[p] = _mm256_set1_ps(planes[p * 4 + 2]);
+        pw[p] = _mm256_set1_ps(planes[p * 4 + 3]);
+    }
+    const __m256 zero = _mm256_setzero_ps();
+    size_t n = 0, i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(xs + i), y = _mm256_loadu_ps(ys + i);
+        __m256 z = _mm256_loadu_ps(zs + i), r = _mm256_loadu_ps(rs + i);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < planeCount; ++p) {
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px[p], x), _mm256_mul_ps(py[p], y)),
+                                     _mm256_add_ps(_mm256_mul_ps(pz[p], z), _mm256_add_ps(pw[p], r)));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, zero, _CMP_GE_OQ));
+        }
+        n += emitVisible((unsigned int)_mm256_movemask_ps(inside), (uint32_t)i, out + n);
+    }
+    processed = i;
+    return n;
+}
+
+size_t cullAabbsAvx(const float* planes, int planeCount, const float* cxs, const float* cys, const float* czs,
+                    const float* exs, const float* eys, const float* ezs, size_t count, uint32_t* out, size_t& processed)
+{
+    // A box reaches toward a plane by its extent projected on |normal|
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    __m256 px[MAX_PLANES], py[MAX_PLANES], pz[MAX_PLANES], pw[MAX_PLANES];
+    __m256 ax[MAX_PLANES], ay[MAX_PLANES], az[MAX_PLANES];
+    for (int p = 0; p < planeCount; ++p) {
+        px[p] = _mm256_set1_ps(planes[p * 4 + 0]);
+        py[p] = _mm256_set1_ps(planes[p * 4 + 1]);
+        pz[p] = _mm256_set1_ps(planes[p * 4 + 2]);
+        pw[p] = _mm256_set1_ps(planes[p * 4 + 3]);
+        ax[p] = _mm256_andnot_ps(signBit, px[p]);
+        ay[p] = _mm256_andnot_ps(signBit, py[p]);
+        az[p] = _mm256_andnot_ps(signBit, pz[p]);
+    }
+    const __m256 zero = _mm256_setzero_ps();
+    size_t n = 0, i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 cx = _mm256_loadu_ps(cxs + i), cy = _mm256_loadu_ps(cys + i), cz = _mm256_loadu_ps(czs + i);
+        __m256 ex = _mm256_loadu_ps(exs + i), ey = _mm256_loadu_ps(eys + i), ez = _mm256_loadu_ps(ezs + i);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < planeCount; ++p) {
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px[p], cx), _mm256_mul_ps(py[p], cy)),
+                                     _mm256_add_ps(_mm256_mul_ps(pz[p], cz), pw[p]));
+            __m256 reach = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax[p], ex), _mm256_mul_ps(ay[p], ey)),
+                                         _mm256_mul_ps(az[p], ez));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(d, reach), zero, _CMP_GE_OQ));
+        }
+        n += emitVisible((unsigned int)_mm256_movemask_ps(inside), (uint32_t)i, out + n);
+    }
+    processed = i;
+    return n;
+}
+
+#else
+
+size_t cullSpheresAvx(const float*, int, const float*, const float*, const float*,
+                      const float*, size_t, uint32_t*, size_t& processed)
+{
+    processed = 0;
+    return 0;
+}
+
+size_t cullAabbsAvx(const float*, int, const float*, const float*, const float*,
+                    const float*, const float*, const float*, size_t, uint32_t*, size_t& processed)
+{
+    processed = 0;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,60 @@
+/* GLCaps.cpp */
+#include "GLCaps.h"
+
+const GLCaps& GLCaps::get()
+{
+    static GLCaps caps;
+    return caps;
+}
+
+GLCaps::GLCaps()
+{
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const GLubyte* name = glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (name)
+            m_extensions.insert(reinterpret_cast<const char*>(name));
+    }
+
+    // Our SSBO shader path is written against GLSL 4.30, so the extension alone is not enough
+    shaderStorageBuffers = hasVersion(4, 3);
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTextureBufferSize);
+    if (shaderStorageBuffers)
+        glGetInteger64v(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &maxShaderStorageBlockSize);
+
+    textureCompressionS3TC = hasExtension("GL_EXT_texture_compression_s3tc");
+    textureCompressionS3TCsRGB = textureCompressionS3TC
+        && (hasExtension("GL_EXT_texture_sRGB") || hasExtension("GL_EXT_texture_compression_s3tc_srgb"));
+    textureCompressionRGTC = hasVersion(3, 0) || hasExtension("GL_ARB_texture_compression_rgtc");
+}
+
+bool GLCaps::hasVersion(int wantMajor, int wantMinor) const
+{
+    return major > wantMajor || (major == wantMajor && minor >= wantMinor);
+}
+
+bool GLCaps::hasExtension(const std::string& name) const
+{
+    return m_extensions.count(name) != 0;
+}
+
+bool GLCaps::supportsCompressedFormat(GLenum internalFormat) const
+{
+    switch (internalFormat) {
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        return textureCompressionS3TC;
+    case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+        return textureCompressionS3TCsRGB;
+    case GL_COMPRESSED_RED_RGTC1:
+    case GL_COMPRESSED_RG_RGTC2:
+        return textureCompressionRGTC;
+    default:
+        return false;
+    }
+}
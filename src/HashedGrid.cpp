@@ -0,0 +1,273 @@
+/* HashedGrid.cpp */
+#include "HashedGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+    // Cell coordinates are packed into 21 bits each
+    const int COORD_LIMIT = (1 << 20) - 1;
+}
+
+HashedGrid::HashedGrid(float cellSize)
+    : m_cellSize(cellSize), m_invCellSize(1.0f / cellSize)
+{
+}
+
+bool HashedGrid::fitsCell(const Aabb& bounds) const
+{
+    glm::vec3 size = bounds.max - bounds.min;
+    if (std::max(size.x, std::max(size.y, size.z)) > m_cellSize)
+        return false;
+    // Past the packable range the clamped edge cell's loose bounds would not
+    // contain the object; written so NaN centers fail too
+    glm::vec3 c = glm::floor(bounds.center() * m_invCellSize);
+    for (int a = 0; a < 3; ++a) {
+        if (!(c[a] >= (float)-COORD_LIMIT && c[a] <= (float)COORD_LIMIT))
+            return false;
+    }
+    return true;
+}
+
+glm::ivec3 HashedGrid::cellCoord(const glm::vec3& p) const
+{
+    glm::vec3 c = glm::floor(p * m_invCellSize);
+    c = glm::clamp(c, glm::vec3((float)-COORD_LIMIT), glm::vec3((float)COORD_LIMIT));
+    return glm::ivec3(c);
+}
+
+uint64_t HashedGrid::cellKey(const glm::ivec3& coord)
+{
+    const uint64_t mask = (1u << 21) - 1;
+    return ((uint64_t)(coord.x + COORD_LIMIT) & mask)
+         | (((uint64_t)(coord.y + COORD_LIMIT) & mask) << 21)
+         | (((uint64_t)(coord.z + COORD_LIMIT) & mask) << 42);
+}
+
+uint32_t HashedGrid::cellFor(const Aabb& bounds)
+{
+    if (!fitsCell(bounds))
+        return OVERSIZED;
+
+    glm::ivec3 coord = cellCoord(bounds.center());
+    auto it = m_cellLookup.find(cellKey(coord));
+    if (it != m_cellLookup.end())
+        return it->second;
+
+    uint32_t cell;
+    if (!m_freeCells.empty()) {
+        cell = m_freeCells.back();
+        m_freeCells.pop_back();
+    }
+    else {
+        cell = (uint32_t)m_cells.size();
+        m_cells.push_back(Cell());
+    }
+    m_cells[cell].coord = coord;
+    m_cellLookup.emplace(cellKey(coord), cell);
+    return cell;
+}
+
+std::vector<uint32_t>& HashedGrid::listOf(uint32_t cell)
+{
+    return cell == OVERSIZED ? m_oversized : m_cells[cell].objects;
+}
+
+void HashedGrid::link(uint32_t object, uint32_t cell)
+{
+    std::vector<uint32_t>& list = listOf(cell);
+    m_entries[object].cell = cell;
+    m_entries[object].slot = (uint32_t)list.size();
+    list.push_back(object);
+}
+
+void HashedGrid::unlink(uint32_t object)
+{
+    Entry& entry = m_entries[object];
+    std::vector<uint32_t>& list = listOf(entry.cell);
+    uint32_t last = list.back();
+    list[entry.slot] = last;
+    m_entries[last].slot = entry.slot;
+    list.pop_back();
+
+    // Emptied cells go back to the free list so wandering objects do not
+    // leave a trail of dead cells behind
+    if (entry.cell != OVERSIZED && list.empty()) {
+        m_cellLookup.erase(cellKey(m_cells[entry.cell].coord));
+        m_freeCells.push_back(entry.cell);
+    }
+    entry.cell = NO_CELL;
+}
+
+Aabb HashedGrid::looseBounds(const Cell& cell) const
+{
+    glm::vec3 lo = glm::vec3(cell.coord) * m_cellSize;
+    float half = m_cellSize * 0.5f;
+    return Aabb(lo - half, lo + m_cellSize + half);
+}
+
+void HashedGrid::insert(uint32_t object, const Aabb& bounds)
+{
+    if (object >= m_entries.size())
+        m_entries.resize(object + 1);
+    if (m_entries[object].cell != NO_CELL) {
+        move(object, bounds);
+        return;
+    }
+    m_entries[object].bounds = bounds;
+    link(object, cellFor(bounds));
+    ++m_objectCount;
+}
+
+void HashedGrid::move(uint32_t object, const Aabb& bounds)
+{
+    if (object >= m_entries.size() || m_entries[object].cell == NO_CELL) {
+        insert(object, bounds);
+        return;
+    }
+    Entry& entry = m_entries[object];
+    entry.bounds = bounds;
+
+    // Most moves stay within the same cell and only update the box
+    bool oversized = !fitsCell(bounds);
+    if (oversized ? entry.cell == OVERSIZED
+                  : entry.cell != OVERSIZED && m_cells[entry.cell].coord == cellCoord(bounds.center()))
+        return;
+
+    unlink(object);
+    link(object, cellFor(bounds));
+}
+
+void HashedGrid::remove(uint32_t object)
+{
+    if (object >= m_entries.size() || m_entries[object].cell == NO_CELL)
+        return;
+    unlink(object);
+    --m_objectCount;
+}
+
+void HashedGrid::clear()
+{
+    m_entries.clear();
+    m_cells.clear();
+    m_freeCells.clear();
+    m_cellLookup.clear();
+    m_oversized.clear();
+    m_objectCount = 0;
+}
+
+void HashedGrid::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& objects) const
+{
+    objects.clear();
+    m_candidates.clear();
+    m_candidateObjects.clear();
+    const unsigned int ALL_PLANES = (1u << Frustum::PLANE_COUNT) - 1;
+
+    // Cells fully inside are taken whole; objects of straddling cells are
+    // gathered and tested in one batch below
+    auto testObjects = [&](const std::vector<uint32_t>& list, unsigned int mask) {
+        for (uint32_t object : list) {
+            if (mask == 0) {
+                objects.push_back(object);
+                continue;
+            }
+            m_candidates.push(m_entries[object].bounds.min, m_entries[object].bounds.max);
+            m_candidateObjects.push_back(object);
+        }
+    };
+
+    for (const Cell& cell : m_cells) {
+        if (cell.objects.empty())
+            continue;
+        Aabb loose = looseBounds(cell);
+        unsigned int mask = ALL_PLANES;
+        if (frustum.classifyBox(loose.center(), loose.extent(), mask) == Frustum::SIDE_OUTSIDE)
+            continue;
+        testObjects(cell.objects, mask);
+    }
+    testObjects(m_oversized, ALL_PLANES);
+
+    cullAabbs(frustum, m_candidates, m_candidateVisible);
+    for (uint32_t candidate : m_candidateVisible)
+        objects.push_back(m_candidateObjects[candidate]);
+}
+
+void HashedGrid::querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& objects) const
+{
+    objects.clear();
+
+    auto testObjects = [&](const std::vector<uint32_t>& list) {
+        for (uint32_t object : list) {
+            if (m_entries[object].bounds.intersectsSphere(center, radius))
+                objects.push_back(object);
+        }
+    };
+
+    // Small spheres look up the few cells they can reach; large ones are
+    // cheaper to answer by scanning the occupied cells
+    float reach = radius + m_cellSize * 0.5f;
+    glm::ivec3 lo = cellCoord(center - reach), hi = cellCoord(center + reach);
+    glm::ivec3 span = hi - lo + 1;
+    double volume = (double)span.x * span.y * span.z;
+
+    if (volume <= (double)m_cellLookup.size()) {
+        for (int z = lo.z; z <= hi.z; ++z) {
+            for (int y = lo.y; y <= hi.y; ++y) {
+                for (int x = lo.x; x <= hi.x; ++x) {
+                    auto it = m_cellLookup.find(cellKey(glm::ivec3(x, y, z)));
+                    if (it != m_cellLookup.end())
+                        testObjects(m_cells[it->second].objects);
+                }
+            }
+        }
+    }
+    else {
+        for (const Cell& cell : m_cells) {
+            if (!cell.objects.empty() && looseBounds(cell).intersectsSphere(center, radius))
+                testObjects(cell.objects);
+        }
+    }
+    testObjects(m_oversized);
+}
+
+bool HashedGrid::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                         uint32_t& object, float& distance) const
+{
+    glm::vec3 invDirection;
+    for (int a = 0; a < 3; ++a)
+        invDirection[a] = 1.0f / (std::abs(direction[a]) > 1e-12f ? direction[a] : 1e-12f);
+
+    float best = maxDistance;
+    bool hit = false;
+    auto testObjects = [&](const std::vector<uint32_t>& list) {
+        for (uint32_t candidate : list) {
+            float t;
+            if (m_entries[candidate].bounds.intersectsRay(origin, invDirection, best, t) && (!hit || t < best)) {
+                best = t;
+                object = candidate;
+                hit = true;
+            }
+        }
+    };
+    testObjects(m_oversized);
+
+    // Visit the cells the ray enters in order and stop once the nearest hit
+    // so far is closer than the next cell
+    std::vector<std::pair<float, uint32_t>> cells;
+    for (uint32_t c = 0; c < (uint32_t)m_cells.size(); ++c) {
+        float t;
+        if (!m_cells[c].objects.empty() && looseBounds(m_cells[c]).intersectsRay(origin, invDirection, best, t))
+            cells.push_back({ t, c });
+    }
+    std::sort(cells.begin(), cells.end());
+    for (const std::pair<float, uint32_t>& cell : cells) {
+        if (hit && cell.first > best)
+            break;
+        testObjects(m_cells[cell.second].objects);
+    }
+
+    if (hit)
+        distance = best;
+    return hit;
+}
@@ -0,0 +1,56 @@
+/* InstanceBuffer.cpp */
+#include "InstanceBuffer.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+
+void InstanceBuffer::create()
+{
+    glGenBuffers(1, &m_vbo);
+}
+
+void InstanceBuffer::attachTo(unsigned int vao) const
+{
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+    // A matrix attribute occupies one location per column
+    const GLsizei stride = sizeof(InstanceData);
+    for (unsigned int column = 0; column < 4; ++column) {
+        unsigned int location = MODEL_LOCATION + column;
+        size_t offset = offsetof(InstanceData, model) + column * sizeof(glm::vec4);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, stride, (void*)offset);
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+    for (unsigned int column = 0; column < 3; ++column) {
+        unsigned int location = NORMAL_LOCATION + column;
+        size_t offset = offsetof(InstanceData, normal) + column * sizeof(glm::vec3);
+        glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, stride, (void*)offset);
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+    glBindVertexArray(0);
+}
+
+void InstanceBuffer::upload(const InstanceData* instances, size_t count)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    if (count > m_capacity) {
+        m_capacity = std::max(count, m_capacity * 2);
+    }
+    // Orphan the old storage, then fill the new one
+    glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+    if (count > 0)
+        glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(InstanceData), instances);
+    m_count = count;
+}
+
+void InstanceBuffer::release()
+{
+    if (m_vbo != 0)
+        glDeleteBuffers(1, &m_vbo);
+    m_vbo = 0;
+    m_capacity = 0;
+    m_count = 0;
+}
@@ -4,183 +4,521 @@
 
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <string>
 
-//------------------------------------------------------------------------------
-// Helper: single cube VAO for drawing point-light shapes
 namespace {
-    static unsigned int cubeVAO = 0;
-    static unsigned int cubeVBO = 0;
-    void initCube() {
-        if (cubeVAO != 0)
-            return;
-        float vertices[] = {
-            // positions
-            -0.5f, -0.5f, -0.5f,
-             0.5f, -0.5f, -0.5f,
-             0.5f,  0.5f, -0.5f,
-             0.5f,  0.5f, -0.5f,
-            -0.5f,  0.5f, -0.5f,
-            -0.5f, -0.5f, -0.5f,
-
-            -0.5f, -0.5f,  0.5f,
-             0.5f, -0.5f,  0.5f,
-             0.5f,  0.5f,  0.5f,
-             0.5f,  0.5f,  0.5f,
-            -0.5f,  0.5f,  0.5f,
-            -0.5f, -0.5f,  0.5f,
-
-            -0.5f,  0.5f,  0.5f,
-            -0.5f,  0.5f, -0.5f,
-            -0.5f, -0.5f, -0.5f,
-            -0.5f, -0.5f, -0.5f,
-            -0.5f, -0.5f,  0.5f,
-            -0.5f,  0.5f,  0.5f,
-
-             0.5f,  0.5f,  0.5f,
-             0.5f,  0.5f, -0.5f,
-             0.5f, -0.5f, -0.5f,
-             0.5f, -0.5f, -0.5f,
-             0.5f, -0.5f,  0.5f,
-             0.5f,  0.5f,  0.5f,
-
-            -0.5f, -0.5f, -0.5f,
-             0.5f, -0.5f, -0.5f,
-             0.5f, -0.5f,  0.5f,
-             0.5f, -0.5f,  0.5f,
-            -0.5f, -0.5f,  0.5f,
-            -0.5f, -0.5f, -0.5f,
-
-            -0.5f,  0.5f, -0.5f,
-             0.5f,  0.5f, -0.5f,
-             0.5f,  0.5f,  0.5f,
-             0.5f,  0.5f,  0.5f,
-            -0.5f,  0.5f,  0.5f,
-            -0.5f,  0.5f, -0.5f
-        };
-        glGenVertexArrays(1, &cubeVAO);
-        glGenBuffers(1, &cubeVBO);
-        glBindVertexArray(cubeVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
+    // Dirty point light runs closer than this are merged into one buffer update
+    const size_t DIRTY_RUN_MERGE_GAP = 4;
+
+    // Radii divide by the influence threshold; below this they explode
+    const float MIN_INFLUENCE_THRESHOLD = 1e-4f;
+
+    // Relative luminance of a linear RGB color (Rec. 709 weights)
+    float luminance(const glm::vec3& c) {
+        return glm::dot(c, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+    }
+
+    // Move the last element into slot i and shrink; keeps every pool array dense
+    template <typename T>
+    void removeSwap(std::vector<T>& v, size_t i) {
+        v[i] = v.back();
+        v.pop_back();
     }
 }
 
 //------------------------------------------------------------------------------
-// DirectionalLight
-DirectionalLight::DirectionalLight(const DirectionalLightDesc& desc)
-    : m_desc(desc)
+// DirectionalLightPool
+void DirectionalLightPool::push(const DirectionalLightDesc& desc)
+{
+    direction.push_back(desc.direction);
+    ambient.push_back(desc.ambient);
+    diffuse.push_back(desc.diffuse);
+    specular.push_back(desc.specular);
+}
+
+void DirectionalLightPool::set(size_t i, const DirectionalLightDesc& desc)
 {
+    direction[i] = desc.direction;
+    ambient[i] = desc.ambient;
+    diffuse[i] = desc.diffuse;
+    specular[i] = desc.specular;
 }
 
-void DirectionalLight::uploadToShader(const Shader& shader, int /*index*/) const
+DirectionalLightDesc DirectionalLightPool::get(size_t i) const
 {
-    shader.setVec3("dirLight.direction", m_desc.direction);
-    shader.setVec3("dirLight.ambient", m_desc.ambient);
-    shader.setVec3("dirLight.diffuse", m_desc.diffuse);
-    shader.setVec3("dirLight.specular", m_desc.specular);
+    DirectionalLightDesc desc;
+    desc.direction = direction[i];
+    desc.ambient = ambient[i];
+    desc.diffuse = diffuse[i];
+    desc.specular = specular[i];
+    return desc;
 }
 
-void DirectionalLight::drawShape(const Shader& /*shader*/) const
+void DirectionalLightPool::removeSwap(size_t i)
 {
-    // No visual shape for a directional light
+    ::removeSwap(direction, i);
+    ::removeSwap(ambient, i);
+    ::removeSwap(diffuse, i);
+    ::removeSwap(specular, i);
 }
 
 //------------------------------------------------------------------------------
-// PointLight
-PointLight::PointLight(const PointLightDesc& desc)
-    : m_desc(desc)
+// PointLightPool
+void PointLightPool::push(const PointLightDesc& desc)
+{
+    position.push_back(desc.position);
+    ambient.push_back(desc.ambient);
+    diffuse.push_back(desc.diffuse);
+    specular.push_back(desc.specular);
+    constant.push_back(desc.constant);
+    linear.push_back(desc.linear);
+    quadratic.push_back(desc.quadratic);
+    radius.push_back(0.0f);
+}
+
+void PointLightPool::set(size_t i, const PointLightDesc& desc)
 {
+    position[i] = desc.position;
+    ambient[i] = desc.ambient;
+    diffuse[i] = desc.diffuse;
+    specular[i] = desc.specular;
+    constant[i] = desc.constant;
+    linear[i] = desc.linear;
+    quadratic[i] = desc.quadratic;
 }
 
-void PointLight::uploadToShader(const Shader& shader, int index) const
+PointLightDesc PointLightPool::get(size_t i) const
 {
-    std::string prefix = "pointLights[" + std::to_string(index) + "]";
-    shader.setVec3(prefix + ".position", m_desc.position);
-    shader.setVec3(prefix + ".ambient", m_desc.ambient);
-    shader.setVec3(prefix + ".diffuse", m_desc.diffuse);
-    shader.setVec3(prefix + ".specular", m_desc.specular);
-    shader.setFloat(prefix + ".constant", m_desc.constant);
-    shader.setFloat(prefix + ".linear", m_desc.linear);
-    shader.setFloat(prefix + ".quadratic", m_desc.quadratic);
+    PointLightDesc desc;
+    desc.position = position[i];
+    desc.ambient = ambient[i];
+    desc.diffuse = diffuse[i];
+    desc.specular = specular[i];
+    desc.constant = constant[i];
+    desc.linear = linear[i];
+    desc.quadratic = quadratic[i];
+    return desc;
 }
 
-void PointLight::drawShape(const Shader& shader) const
+void PointLightPool::removeSwap(size_t i)
 {
-    initCube();
-    glm::mat4 model = glm::translate(glm::mat4(1.0f), m_desc.position)
-        * glm::scale(glm::mat4(1.0f), glm::vec3(0.2f));
-    shader.setMat4("model", model);
-    glBindVertexArray(cubeVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+    ::removeSwap(position, i);
+    ::removeSwap(ambient, i);
+    ::removeSwap(diffuse, i);
+    ::removeSwap(specular, i);
+    ::removeSwap(constant, i);
+    ::removeSwap(linear, i);
+    ::removeSwap(quadratic, i);
+    ::removeSwap(radius, i);
 }
 
 //------------------------------------------------------------------------------
-// SpotLight
-SpotLight::SpotLight(const SpotLightDesc& desc)
-    : m_desc(desc)
+// SpotLightPool
+void SpotLightPool::push(const SpotLightDesc& desc)
 {
+    position.push_back(desc.position);
+    direction.push_back(desc.direction);
+    ambient.push_back(desc.ambient);
+    diffuse.push_back(desc.diffuse);
+    specular.push_back(desc.specular);
+    constant.push_back(desc.constant);
+    linear.push_back(desc.linear);
+    quadratic.push_back(desc.quadratic);
+    cutOff.push_back(desc.cutOff);
+    outerCutOff.push_back(desc.outerCutOff);
+    radius.push_back(0.0f);
 }
 
-void SpotLight::uploadToShader(const Shader& shader, int /*index*/) const
+void SpotLightPool::set(size_t i, const SpotLightDesc& desc)
 {
-    shader.setVec3("spotLight.position", m_desc.position);
-    shader.setVec3("spotLight.direction", m_desc.direction);
-    shader.setVec3("spotLight.ambient", m_desc.ambient);
-    shader.setVec3("spotLight.diffuse", m_desc.diffuse);
-    shader.setVec3("spotLight.specular", m_desc.specular);
-    shader.setFloat("spotLight.constant", m_desc.constant);
-    shader.setFloat("spotLight.linear", m_desc.linear);
-    shader.setFloat("spotLight.quadratic", m_desc.quadratic);
-    shader.setFloat("spotLight.cutOff", m_desc.cutOff);
-    shader.setFloat("spotLight.outerCutOff", m_desc.outerCutOff);
+    position[i] = desc.position;
+    direction[i] = desc.direction;
+    ambient[i] = desc.ambient;
+    diffuse[i] = desc.diffuse;
+    specular[i] = desc.specular;
+    constant[i] = desc.constant;
+    linear[i] = desc.linear;
+    quadratic[i] = desc.quadratic;
+    cutOff[i] = desc.cutOff;
+    outerCutOff[i] = desc.outerCutOff;
 }
 
-void SpotLight::drawShape(const Shader& /*shader*/) const
+SpotLightDesc SpotLightPool::get(size_t i) const
 {
-    // Visualization of a spot light can be implemented here
+    SpotLightDesc desc;
+    desc.position = position[i];
+    desc.direction = direction[i];
+    desc.ambient = ambient[i];
+    desc.diffuse = diffuse[i];
+    desc.specular = specular[i];
+    desc.constant = constant[i];
+    desc.linear = linear[i];
+    desc.quadratic = quadratic[i];
+    desc.cutOff = cutOff[i];
+    desc.outerCutOff = outerCutOff[i];
+    return desc;
+}
+
+void SpotLightPool::removeSwap(size_t i)
+{
+    ::removeSwap(position, i);
+    ::removeSwap(direction, i);
+    ::removeSwap(ambient, i);
+    ::removeSwap(diffuse, i);
+    ::removeSwap(specular, i);
+    ::removeSwap(constant, i);
+    ::removeSwap(linear, i);
+    ::removeSwap(quadratic, i);
+    ::removeSwap(cutOff, i);
+    ::removeSwap(outerCutOff, i);
+    ::removeSwap(radius, i);
 }
 
 //------------------------------------------------------------------------------
 // LightingManager
-void LightingManager::addDirectional(const DirectionalLightDesc& desc)
+LightingManager::LightingManager(StorageBackend storage)
 {
-    m_lights.push_back(std::make_unique<DirectionalLight>(desc));
+    unsigned int binding = storage == StorageBackend::ShaderStorage ? POINT_LIGHTS_SSBO_BINDING
+                                                                    : POINT_LIGHTS_TEXTURE_UNIT;
+    m_pointStorage.create(storage, GL_RGBA32F, binding);
 }
 
-void LightingManager::addPoint(const PointLightDesc& desc)
+LightHandle LightingManager::addDirectional(const DirectionalLightDesc& desc)
 {
-    m_lights.push_back(std::make_unique<PointLight>(desc));
+    m_directional.push(desc);
+    m_headerDirty = true;
+    return LightHandle{ LightType::Directional, m_directionalHandles.create() };
 }
 
-void LightingManager::addSpot(const SpotLightDesc& desc)
+LightHandle LightingManager::addPoint(const PointLightDesc& desc)
 {
-    m_lights.push_back(std::make_unique<SpotLight>(desc));
+    m_point.push(desc);
+    m_point.radius.back() = influenceRadius(desc.ambient, desc.diffuse, desc.specular,
+                                            desc.constant, desc.linear, desc.quadratic);
+    m_pointData.emplace_back();
+    m_pointDirty.push_back(0);
+    m_pointVisible.push_back(1);
+    ++m_visiblePointCount;
+    markPointDirty(m_point.size() - 1);
+    m_headerDirty = true;
+    return LightHandle{ LightType::Point, m_pointHandles.create() };
 }
 
-void LightingManager::uploadToShader(const Shader& shader) const
+LightHandle LightingManager::addSpot(const SpotLightDesc& desc)
 {
-    int pointCount = 0;
-    for (const auto& light : m_lights) {
-        if (auto dl = dynamic_cast<DirectionalLight*>(light.get())) {
-            dl->uploadToShader(shader);
-        }
-        else if (auto pl = dynamic_cast<PointLight*>(light.get())) {
-            pl->uploadToShader(shader, pointCount);
-            ++pointCount;
-        }
-        else if (auto sl = dynamic_cast<SpotLight*>(light.get())) {
-            sl->uploadToShader(shader);
+    m_spot.push(desc);
+    m_spot.radius.back() = influenceRadius(desc.ambient, desc.diffuse, desc.specular,
+                                           desc.constant, desc.linear, desc.quadratic);
+    m_headerDirty = true;
+    return LightHandle{ LightType::Spot, m_spotHandles.create() };
+}
+
+bool LightingManager::updateDirectional(LightHandle light, const DirectionalLightDesc& desc)
+{
+    if (light.type != LightType::Directional || !contains(light))
+        return false;
+    uint32_t index = m_directionalHandles.indexOf(light.handle);
+    m_directional.set(index, desc);
+    // Only the first directional light reaches the shader
+    if (index == 0)
+        m_headerDirty = true;
+    return true;
+}
+
+bool LightingManager::updatePoint(LightHandle light, const PointLightDesc& desc)
+{
+    if (light.type != LightType::Point || !contains(light))
+        return false;
+    uint32_t index = m_pointHandles.indexOf(light.handle);
+    m_point.set(index, desc);
+    m_point.radius[index] = influenceRadius(desc.ambient, desc.diffuse, desc.specular,
+                                            desc.constant, desc.linear, desc.quadratic);
+    markPointDirty(index);
+    return true;
+}
+
+bool LightingManager::updateSpot(LightHandle light, const SpotLightDesc& desc)
+{
+    if (light.type != LightType::Spot || !contains(light))
+        return false;
+    uint32_t index = m_spotHandles.indexOf(light.handle);
+    m_spot.set(index, desc);
+    m_spot.radius[index] = influenceRadius(desc.ambient, desc.diffuse, desc.specular,
+                                           desc.constant, desc.linear, desc.quadratic);
+    // Only the first spot light reaches the shader
+    if (index == 0)
+        m_headerDirty = true;
+    return true;
+}
+
+bool LightingManager::remove(LightHandle light)
+{
+    if (!contains(light))
+        return false;
+    uint32_t index = tableFor(light.type).destroy(light.handle);
+    switch (light.type) {
+    case LightType::Directional:
+        m_directional.removeSwap(index);
+        break;
+    case LightType::Point:
+        if (m_pointVisible[index])
+            --m_visiblePointCount;
+        m_point.removeSwap(index);
+        ::removeSwap(m_pointVisible, index);
+        m_pointData.pop_back();
+        m_pointDirty.pop_back();
+        // The former last light now occupies the hole
+        if (index < m_point.size())
+            markPointDirty(index);
+        break;
+    case LightType::Spot:
+        m_spot.removeSwap(index);
+        break;
+    }
+    m_headerDirty = true;
+    return true;
+}
+
+bool LightingManager::contains(LightHandle light) const
+{
+    return tableFor(light.type).contains(light.handle);
+}
+
+HandleTable& LightingManager::tableFor(LightType type)
+{
+    return const_cast<HandleTable&>(static_cast<const LightingManager*>(this)->tableFor(type));
+}
+
+const HandleTable& LightingManager::tableFor(LightType type) const
+{
+    switch (type) {
+    case LightType::Directional: return m_directionalHandles;
+    case LightType::Spot:        return m_spotHandles;
+    default:                     return m_pointHandles;
+    }
+}
+
+void LightingManager::bindToShader(const Shader& shader) const
+{
+    unsigned int blockIndex = glGetUniformBlockIndex(shader.ID, "Lights");
+    if (blockIndex != GL_INVALID_INDEX)
+        glUniformBlockBinding(shader.ID, blockIndex, LIGHTS_BINDING);
+
+    // The SSBO binding is fixed in the shader; the texture buffer needs its sampler set
+    if (storageBackend() == StorageBackend::TextureBuffer) {
+        shader.use();
+        shader.setInt("pointLightData", (int)POINT_LIGHTS_TEXTURE_UNIT);
+    }
+}
+
+void LightingManager::setInfluenceThreshold(float luminance)
+{
+    // Zero, negative or NaN would give inf/NaN radii that break culling and clustering
+    m_influenceThreshold = luminance > MIN_INFLUENCE_THRESHOLD ? luminance : MIN_INFLUENCE_THRESHOLD;
+    for (size_t i = 0; i < m_point.size(); ++i) {
+        m_point.radius[i] = influenceRadius(m_point.ambient[i], m_point.diffuse[i], m_point.specular[i],
+                                            m_point.constant[i], m_point.linear[i], m_point.quadratic[i]);
+    }
+    for (size_t i = 0; i < m_spot.size(); ++i) {
+        m_spot.radius[i] = influenceRadius(m_spot.ambient[i], m_spot.diffuse[i], m_spot.specular[i],
+                                           m_spot.constant[i], m_spot.linear[i], m_spot.quadratic[i]);
+    }
+}
+
+float LightingManager::influenceRadius(const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular,
+                                       float constant, float linear, float quadratic) const
+{
+    // Solve peak / (c + l*d + q*d^2) = threshold for d
+    float peak = std::max(luminance(ambient), std::max(luminance(diffuse), luminance(specular)));
+    float k = constant - peak / m_influenceThreshold;
+    if (k >= 0.0f)
+        return 0.0f;
+    if (quadratic <= 0.0f)
+        return linear > 0.0f ? -k / linear : std::numeric_limits<float>::max();
+    return (-linear + std::sqrt(linear * linear - 4.0f * quadratic * k)) / (2.0f * quadratic);
+}
+
+void LightingManager::cull(const Frustum& frustum)
+{
+    m_visiblePointCount = 0;
+    for (size_t i = 0; i < m_point.size(); ++i) {
+        uint8_t visible = m_point.radius[i] > 0.0f && frustum.intersectsSphere(m_point.position[i], m_point.radius[i]);
+        m_pointVisible[i] = visible;
+        m_visiblePointCount += visible;
+    }
+
+    bool spotVisible = m_spot.size() > 0 && m_spot.radius[0] > 0.0f
+        && frustum.intersectsCone(m_spot.position[0], glm::normalize(m_spot.direction[0]),
+                                  m_spot.radius[0], m_spot.outerCutOff[0]);
+    if (spotVisible != m_spotVisible) {
+        m_spotVisible = spotVisible;
+        m_headerDirty = true;
+    }
+}
+
+void LightingManager::markPointDirty(size_t index)
+{
+    m_pointDirty[index] = 1;
+    m_anyPointDirty = true;
+}
+
+void LightingManager::packHeader()
+{
+    // The shader has a single directional and spot slot; an empty pool leaves them black
+    DirLightStd140& d = m_block.dirLight;
+    d = DirLightStd140{};
+    if (m_directional.size() > 0) {
+        d.direction = m_directional.direction[0];
+        d.ambient = m_directional.ambient[0];
+        d.diffuse = m_directional.diffuse[0];
+        d.specular = m_directional.specular[0];
+    }
+
+    SpotLightStd140& sp = m_block.spotLight;
+    sp = SpotLightStd140{};
+    m_block.spotEnabled = m_spot.size() > 0 && m_spotVisible;
+    if (m_block.spotEnabled) {
+        sp.position = m_spot.position[0];
+        sp.direction = m_spot.direction[0];
+        sp.ambient = m_spot.ambient[0];
+        sp.diffuse = m_spot.diffuse[0];
+        sp.specular = m_spot.specular[0];
+        sp.constant = m_spot.constant[0];
+        sp.linear = m_spot.linear[0];
+        sp.quadratic = m_spot.quadratic[0];
+        sp.cutOff = m_spot.cutOff[0];
+        sp.outerCutOff = m_spot.outerCutOff[0];
+    }
+    else {
+        // Keep attenuation finite so the unused slot contributes nothing
+        sp.constant = 1.0f;
+    }
+
+    m_block.pointCount = (int)residentPointCount();
+}
+
+size_t LightingManager::residentPointCount() const
+{
+    return std::min(m_point.size(), m_pointStorage.capacity() / sizeof(PointLightStd140));
+}
+
+void LightingManager::packPoint(size_t i)
+{
+    PointLightStd140& p = m_pointData[i];
+    p.position = m_point.position[i];
+    p.ambient = m_point.ambient[i];
+    p.diffuse = m_point.diffuse[i];
+    p.specular = m_point.specular[i];
+    p.constant = m_point.constant[i];
+    p.linear = m_point.linear[i];
+    p.quadratic = m_point.quadratic[i];
+}
+
+void LightingManager::upload()
+{
+    if (m_ubo == 0) {
+        glGenBuffers(1, &m_ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(LightsBlockStd140), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, LIGHTS_BINDING, m_ubo);
+        m_headerDirty = true;
+    }
+    // Growing the point array reallocates it: everything has to be sent again,
+    // and the header's pointCount may change if the storage hit its limit
+    if (m_pointStorage.reserve(m_point.size() * sizeof(PointLightStd140))) {
+        std::fill(m_pointDirty.begin(), m_pointDirty.end(), 1);
+        m_anyPointDirty = !m_pointDirty.empty();
+        m_headerDirty = true;
+    }
+    if (!m_headerDirty && !m_anyPointDirty)
+        return;
+
+    if (m_headerDirty) {
+        packHeader();
+        glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightsBlockStd140), &m_block);
+        m_headerDirty = false;
+    }
+
+    if (m_anyPointDirty) {
+        // Walk the dirty flags and send each (gap-merged) run of visible lights
+        // with one update. Culled lights keep their flag until they come into view,
+        // and lights past the storage limit keep theirs in case it is ever raised.
+        const size_t count = residentPointCount();
+        bool deferred = false;
+        size_t i = 0;
+        while (i < count) {
+            if (!m_pointDirty[i] || !m_pointVisible[i]) {
+                deferred |= m_pointDirty[i] != 0;
+                ++i;
+                continue;
+            }
+            size_t first = i;
+            size_t last = i;
+            for (size_t j = i + 1; j < count && j <= last + DIRTY_RUN_MERGE_GAP; ++j) {
+                if (m_pointDirty[j] && m_pointVisible[j])
+                    last = j;
+            }
+            for (size_t j = first; j <= last; ++j) {
+                packPoint(j);
+                m_pointDirty[j] = 0;
+            }
+
+            m_pointStorage.update(first * sizeof(PointLightStd140),
+                                  (last - first + 1) * sizeof(PointLightStd140),
+                                  &m_pointData[first]);
+            i = last + 1;
         }
+        m_anyPointDirty = deferred;
     }
-    shader.setInt("NR_POINT_LIGHTS", pointCount);
 }
 
-void LightingManager::drawShapes(const Shader& shader) const
+void LightingManager::enqueueShapes(RenderQueue& queue, uint64_t key, const MeshBuffer& meshes, const MeshRange& shape)
 {
-    for (const auto& light : m_lights) {
-        light->drawShape(shader);
+    // Point lights are drawn as small cubes; directional and spot lights have no shape.
+    // The gizmos get their own VAO over the shared storage so their instance
+    // stream does not replace the one attached to the mesh buffer's VAO.
+    if (m_gizmoSource != &meshes) {
+        if (m_gizmoVAO != 0)
+            glDeleteVertexArrays(1, &m_gizmoVAO);
+        if (!m_gizmoInstances.created())
+            m_gizmoInstances.create();
+        m_gizmoVAO = meshes.createVertexArray();
+        m_gizmoInstances.attachTo(m_gizmoVAO);
+        m_gizmoSource = &meshes;
+    }
+
+    m_gizmoData.clear();
+    for (size_t i = 0; i < m_point.size(); ++i) {
+        if (!m_pointVisible[i])
+            continue;
+        InstanceData instance;
+        instance.model = glm::translate(glm::mat4(1.0f), m_point.position[i])
+            * glm::scale(glm::mat4(1.0f), glm::vec3(0.2f));
+        instance.normal = glm::mat3(1.0f);   // unlit gizmos ignore normals
+        m_gizmoData.push_back(instance);
+    }
+    if (m_gizmoData.empty())
+        return;
+
+    m_gizmoInstances.upload(m_gizmoData);
+    queue.submit(key, makeRenderItem(meshes, m_gizmoVAO, shape, (GLsizei)m_gizmoData.size()));
+}
+
+void LightingManager::release()
+{
+    if (m_ubo != 0) {
+        glDeleteBuffers(1, &m_ubo);
+        m_ubo = 0;
+    }
+    m_pointStorage.release();
+    m_gizmoInstances.release();
+    if (m_gizmoVAO != 0) {
+        glDeleteVertexArrays(1, &m_gizmoVAO);
+        m_gizmoVAO = 0;
     }
+    m_gizmoSource = nullptr;
 }
@@ -0,0 +1,287 @@
+/* MeshBuffer.cpp */
+#include "MeshBuffer.h"
+
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+    // Hash/compare vertices by their exact bits; only true duplicates merge
+    struct VertexKey {
+        Vertex v;
+        bool operator==(const VertexKey& other) const {
+            return std::memcmp(&v, &other.v, sizeof(Vertex)) == 0;
+        }
+    };
+
+    struct VertexKeyHash {
+        size_t operator()(const VertexKey& key) const {
+            uint32_t words[sizeof(Vertex) / sizeof(uint32_t)];
+            std::memcpy(words, &key.v, sizeof(Vertex));
+            // FNV-1a over the 32-bit words
+            size_t h = 2166136261u;
+            for (uint32_t w : words)
+                h = (h ^ w) * 16777619u;
+            return h;
+        }
+    };
+
+    // Byte offsets of each attribute inside one packed vertex
+    struct VertexLayout {
+        size_t position;
+        size_t normal;
+        size_t texCoords;
+        size_t stride;
+    };
+
+    VertexLayout layoutOf(const VertexFormat& format)
+    {
+        VertexLayout layout;
+        layout.position = 0;
+        // Three unorm16 are padded to 8 bytes to keep the next attribute aligned
+        layout.normal = format.position == PositionFormat::Unorm16 ? 8 : 12;
+        layout.texCoords = layout.normal + (format.normal == NormalFormat::Octahedral10 ? 4 : 12);
+        layout.stride = layout.texCoords + (format.texCoords == TexCoordFormat::Half2 ? 4 : 8);
+        return layout;
+    }
+
+    // Fold the unit sphere onto the octahedron, then its lower half onto the upper
+    glm::vec2 encodeOctahedral(const glm::vec3& n)
+    {
+        float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+        if (l1 <= 0.0f)
+            return glm::vec2(0.0f);
+        glm::vec2 e = glm::vec2(n.x, n.y) / l1;
+        if (n.z < 0.0f) {
+            glm::vec2 folded(1.0f - std::abs(e.y), 1.0f - std::abs(e.x));
+            e.x = e.x >= 0.0f ? folded.x : -folded.x;
+            e.y = e.y >= 0.0f ? folded.y : -folded.y;
+        }
+        return e;
+    }
+
+    // Stored as a plain signed integer c = round(v * 511); the shader divides
+    // by 511 itself, since fixed-function snorm conversion differs between
+    // GL 3.3 ((2c + 1) / 1023, which cannot represent 0) and GL 4.2+ (c / 511)
+    uint32_t packSnorm10(float v)
+    {
+        int c = (int)std::lround(std::max(-1.0f, std::min(v, 1.0f)) * 511.0f);
+        return (uint32_t)c & 0x3FFu;
+    }
+
+    uint16_t packUnorm16(float v)
+    {
+        return (uint16_t)std::lround(std::max(0.0f, std::min(v, 1.0f)) * 65535.0f);
+    }
+}
+
+size_t VertexFormat::stride() const
+{
+    return layoutOf(*this).stride;
+}
+
+void addVertexFormatDefines(const VertexFormat& format, ShaderOptions& options)
+{
+    if (format.position == PositionFormat::Unorm16)
+        options.defines.push_back("QUANTIZED_POSITIONS");
+    if (format.normal == NormalFormat::Octahedral10)
+        options.defines.push_back("OCTAHEDRAL_NORMALS");
+    // Half-float UVs are widened by the vertex fetch; the shader needs no change
+}
+
+MeshRange MeshBuffer::add(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount)
+{
+    MeshRange mesh;
+    mesh.firstIndex = (uint32_t)m_indices.size();
+    mesh.indexCount = (uint32_t)indexCount;
+    mesh.baseVertex = (int32_t)m_vertices.size();
+    mesh.vertexCount = (uint32_t)vertexCount;
+
+    if (vertexCount > 0) {
+        glm::vec3 bmin = vertices[0].position, bmax = vertices[0].position;
+        for (size_t i = 1; i < vertexCount; ++i) {
+            bmin = glm::min(bmin, vertices[i].position);
+            bmax = glm::max(bmax, vertices[i].position);
+        }
+        glm::vec3 extent = bmax - bmin;
+        mesh.positionOffset = bmin;
+        mesh.positionScale = glm::vec3(extent.x > 0.0f ? extent.x : 1.0f,
+                                       extent.y > 0.0f ? extent.y : 1.0f,
+                                       extent.z > 0.0f ? extent.z : 1.0f);
+        m_ranges.push_back(mesh);
+    }
+
+    m_vertices.insert(m_vertices.end(), vertices, vertices + vertexCount);
+    m_indices.insert(m_indices.end(), indices, indices + indexCount);
+    if (mesh.vertexCount > m_largestMesh)
+        m_largestMesh = mesh.vertexCount;
+    return mesh;
+}
+
+MeshRange MeshBuffer::addLod(const MeshRange& mesh, const uint32_t* indices, size_t indexCount)
+{
+    MeshRange lod = mesh;
+    lod.firstIndex = (uint32_t)m_indices.size();
+    lod.indexCount = (uint32_t)indexCount;
+    m_indices.insert(m_indices.end(), indices, indices + indexCount);
+    return lod;
+}
+
+MeshRange MeshBuffer::addDeduplicated(const Vertex* vertices, size_t count)
+{
+    std::vector<Vertex> unique;
+    std::vector<uint32_t> indices;
+    std::unordered_map<VertexKey, uint32_t, VertexKeyHash> lookup;
+    unique.reserve(count);
+    indices.reserve(count);
+    lookup.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        VertexKey key{ vertices[i] };
+        auto it = lookup.find(key);
+        if (it == lookup.end()) {
+            it = lookup.emplace(key, (uint32_t)unique.size()).first;
+            unique.push_back(vertices[i]);
+        }
+        indices.push_back(it->second);
+    }
+    return add(unique, indices);
+}
+
+void MeshBuffer::upload()
+{
+    if (m_vao == 0) {
+        glGenVertexArrays(1, &m_vao);
+        glGenBuffers(1, &m_vbo);
+        glGenBuffers(1, &m_ebo);
+    }
+
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    std::vector<uint8_t> packed = packVertices();
+    glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+
+    // Base vertex offsets keep indices mesh-relative, so 16 bits suffice per mesh
+    if (m_largestMesh <= 65536) {
+        m_indexType = GL_UNSIGNED_SHORT;
+        std::vector<uint16_t> shortIndices(m_indices.begin(), m_indices.end());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(uint16_t), shortIndices.data(), GL_STATIC_DRAW);
+    }
+    else {
+        m_indexType = GL_UNSIGNED_INT;
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(uint32_t), m_indices.data(), GL_STATIC_DRAW);
+    }
+
+    setupVertexAttributes();
+    glBindVertexArray(0);
+}
+
+unsigned int MeshBuffer::createVertexArray() const
+{
+    unsigned int vao;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    setupVertexAttributes();
+    glBindVertexArray(0);
+    return vao;
+}
+
+std::vector<uint8_t> MeshBuffer::packVertices() const
+{
+    const VertexLayout layout = layoutOf(m_format);
+    std::vector<uint8_t> packed(m_vertices.size() * layout.stride, 0);
+
+    for (const MeshRange& mesh : m_ranges) {
+        glm::vec3 invScale = 1.0f / mesh.positionScale;
+        for (uint32_t i = 0; i < mesh.vertexCount; ++i) {
+            const Vertex& v = m_vertices[mesh.baseVertex + i];
+            uint8_t* out = &packed[(mesh.baseVertex + i) * layout.stride];
+
+            if (m_format.position == PositionFormat::Unorm16) {
+                glm::vec3 q = (v.position - mesh.positionOffset) * invScale;
+                uint16_t p[3] = { packUnorm16(q.x), packUnorm16(q.y), packUnorm16(q.z) };
+                std::memcpy(out + layout.position, p, sizeof(p));
+            }
+            else {
+                std::memcpy(out + layout.position, &v.position, sizeof(glm::vec3));
+            }
+
+            if (m_format.normal == NormalFormat::Octahedral10) {
+                glm::vec2 e = encodeOctahedral(v.normal);
+                // z and the 2-bit w field are unused and always zero
+                uint32_t n = packSnorm10(e.x) | (packSnorm10(e.y) << 10);
+                std::memcpy(out + layout.normal, &n, sizeof(n));
+            }
+            else {
+                std::memcpy(out + layout.normal, &v.normal, sizeof(glm::vec3));
+            }
+
+            if (m_format.texCoords == TexCoordFormat::Half2) {
+                uint32_t uv = glm::packHalf2x16(v.texCoords);
+                std::memcpy(out + layout.texCoords, &uv, sizeof(uv));
+            }
+            else {
+                std::memcpy(out + layout.texCoords, &v.texCoords, sizeof(glm::vec2));
+            }
+        }
+    }
+    return packed;
+}
+
+void MeshBuffer::setupVertexAttributes() const
+{
+    const VertexLayout layout = layoutOf(m_format);
+    const GLsizei stride = (GLsizei)layout.stride;
+
+    // Position attribute
+    if (m_format.position == PositionFormat::Unorm16)
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)layout.position);
+    else
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)layout.position);
+    glEnableVertexAttribArray(0);
+    // Normal attribute
+    if (m_format.normal == NormalFormat::Octahedral10)
+        // Not normalized: the shader scales the raw integers (see packSnorm10)
+        glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_FALSE, stride, (void*)layout.normal);
+    else
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)layout.normal);
+    glEnableVertexAttribArray(1);
+    // Texture coord attribute
+    if (m_format.texCoords == TexCoordFormat::Half2)
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)layout.texCoords);
+    else
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)layout.texCoords);
+    glEnableVertexAttribArray(2);
+}
+
+const void* MeshBuffer::indexOffset(const MeshRange& mesh) const
+{
+    size_t indexSize = m_indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    return (const void*)(mesh.firstIndex * indexSize);
+}
+
+void MeshBuffer::draw(const MeshRange& mesh) const
+{
+    glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)mesh.indexCount, m_indexType, indexOffset(mesh), mesh.baseVertex);
+}
+
+void MeshBuffer::drawInstanced(const MeshRange& mesh, GLsizei instanceCount) const
+{
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, (GLsizei)mesh.indexCount, m_indexType,
+                                      indexOffset(mesh), instanceCount, mesh.baseVertex);
+}
+
+void MeshBuffer::release()
+{
+    if (m_vao != 0) {
+        glDeleteVertexArrays(1, &m_vao);
+        glDeleteBuffers(1, &m_vbo);
+        glDeleteBuffers(1, &m_ebo);
+    }
+    m_vao = m_vbo = m_ebo = 0;
+}
@@ -0,0 +1,140 @@
+/* MeshCache.cpp */
+#include "MeshCache.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace {
+    const size_t PATH_CAPACITY = 256;
+
+    struct MaterialRecord {
+        char  diffuse[PATH_CAPACITY];
+        char  specular[PATH_CAPACITY];
+        char  normal[PATH_CAPACITY];
+        float shininess;
+    };
+
+    void copyPath(char* dst, const std::string& src)
+    {
+        std::memset(dst, 0, PATH_CAPACITY);
+        std::memcpy(dst, src.data(), std::min(src.size(), PATH_CAPACITY - 1));
+    }
+
+    std::string readPath(const char* src)
+    {
+        return std::string(src, strnlen(src, PATH_CAPACITY));
+    }
+
+    // Bounds-checked view of one array inside the mapping
+    template <typename T>
+    bool copyArray(const MappedFile& file, uint64_t offset, uint32_t count, std::vector<T>& out)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "cache arrays are copied bytewise");
+        uint64_t bytes = (uint64_t)count * sizeof(T);
+        if (offset > file.size() || bytes > file.size() - offset)
+            return false;
+        out.resize(count);
+        if (count > 0)
+            std::memcpy(out.data(), file.data() + offset, (size_t)bytes);
+        return true;
+    }
+}
+
+bool writeMeshCache(const std::string& path, uint64_t sourceHash, const ModelData& model)
+{
+    MeshCacheHeader header{};
+    header.magic = MeshCacheHeader::MAGIC;
+    header.version = MeshCacheHeader::VERSION;
+    header.sourceHash = sourceHash;
+    header.vertexCount = (uint32_t)model.vertices.size();
+    header.indexCount = (uint32_t)model.indices.size();
+    header.subMeshCount = (uint32_t)model.subMeshes.size();
+    header.materialCount = (uint32_t)model.materials.size();
+    for (int i = 0; i < 3; ++i) {
+        header.boundsMin[i] = model.boundsMin[i];
+        header.boundsMax[i] = model.boundsMax[i];
+    }
+    header.vertexOffset = sizeof(MeshCacheHeader);
+    header.indexOffset = header.vertexOffset + model.vertices.size() * sizeof(Vertex);
+    header.subMeshOffset = header.indexOffset + model.indices.size() * sizeof(uint32_t);
+    header.materialOffset = header.subMeshOffset + model.subMeshes.size() * sizeof(SubMeshData);
+    header.lodCount = (uint32_t)model.lods.size();
+    header.lodOffset = header.materialOffset + model.materials.size() * sizeof(MaterialRecord);
+
+    std::vector<MaterialRecord> materials(model.materials.size());
+    for (size_t i = 0; i < materials.size(); ++i) {
+        copyPath(materials[i].diffuse, model.materials[i].diffuse);
+        copyPath(materials[i].specular, model.materials[i].specular);
+        copyPath(materials[i].normal, model.materials[i].normal);
+        materials[i].shininess = model.materials[i].shininess;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return false;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(model.vertices.data()), model.vertices.size() * sizeof(Vertex));
+    out.write(reinterpret_cast<const char*>(model.indices.data()), model.indices.size() * sizeof(uint32_t));
+    out.write(reinterpret_cast<const char*>(model.subMeshes.data()), model.subMeshes.size() * sizeof(SubMeshData));
+    out.write(reinterpret_cast<const char*>(materials.data()), materials.size() * sizeof(MaterialRecord));
+    out.write(reinterpret_cast<const char*>(model.lods.data()), model.lods.size() * sizeof(LodData));
+    return (bool)out;
+}
+
+bool readMeshCache(const std::string& path, uint64_t expectedHash, ModelData& model)
+{
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(MeshCacheHeader))
+        return false;
+
+    MeshCacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.magic != MeshCacheHeader::MAGIC || header.version != MeshCacheHeader::VERSION
+        || header.sourceHash != expectedHash)
+        return false;
+
+    std::vector<MaterialRecord> materials;
+    if (!copyArray(file, header.vertexOffset, header.vertexCount, model.vertices)
+        || !copyArray(file, header.indexOffset, header.indexCount, model.indices)
+        || !copyArray(file, header.subMeshOffset, header.subMeshCount, model.subMeshes)
+        || !copyArray(file, header.materialOffset, header.materialCount, materials)
+        || !copyArray(file, header.lodOffset, header.lodCount, model.lods))
+        return false;
+
+    // Indices are relative to their sub-mesh's baseVertex; one past vertexCount
+    // would read another sub-mesh's vertices or past the vertex buffer
+    auto indicesInRange = [&](uint32_t first, uint32_t count, uint32_t vertexCount) {
+        const uint32_t* index = model.indices.data() + first;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (index[i] >= vertexCount)
+                return false;
+        }
+        return true;
+    };
+    for (const SubMeshData& sub : model.subMeshes) {
+        if ((uint64_t)sub.firstIndex + sub.indexCount > header.indexCount
+            || sub.baseVertex < 0 || (uint64_t)sub.baseVertex + sub.vertexCount > header.vertexCount
+            || (sub.material >= header.materialCount && header.materialCount > 0)
+            || !indicesInRange(sub.firstIndex, sub.indexCount, sub.vertexCount))
+            return false;
+    }
+    for (const LodData& lod : model.lods) {
+        if (lod.subMesh >= header.subMeshCount || (uint64_t)lod.firstIndex + lod.indexCount > header.indexCount
+            || !indicesInRange(lod.firstIndex, lod.indexCount, model.subMeshes[lod.subMesh].vertexCount))
+            return false;
+    }
+
+    model.materials.resize(materials.size());
+    for (size_t i = 0; i < materials.size(); ++i) {
+        model.materials[i].diffuse = readPath(materials[i].diffuse);
+        model.materials[i].specular = readPath(materials[i].specular);
+        model.materials[i].normal = readPath(materials[i].normal);
+        model.materials[i].shininess = materials[i].shininess;
+    }
+    model.boundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    model.boundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+    return true;
+}
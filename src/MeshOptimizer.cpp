@@ -0,0 +1,321 @@
+/* MeshOptimizer.cpp */
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace {
+    // Forsyth scoring constants ("Linear-Speed Vertex Cache Optimisation")
+    const int   LRU_CACHE_SIZE = 32;
+    const float CACHE_DECAY_POWER = 1.5f;
+    const float LAST_TRIANGLE_SCORE = 0.75f;
+    const float VALENCE_BOOST_SCALE = 2.0f;
+    const float VALENCE_BOOST_POWER = 0.5f;
+    const int   MAX_VALENCE_LOOKUP = 32;
+
+    struct ScoreTables {
+        float cache[LRU_CACHE_SIZE];
+        float valence[MAX_VALENCE_LOOKUP];
+
+        ScoreTables()
+        {
+            for (int i = 0; i < LRU_CACHE_SIZE; ++i) {
+                if (i < 3) {
+                    cache[i] = LAST_TRIANGLE_SCORE;
+                }
+                else {
+                    float scaler = 1.0f / (LRU_CACHE_SIZE - 3);
+                    cache[i] = std::pow(1.0f - (i - 3) * scaler, CACHE_DECAY_POWER);
+                }
+            }
+            valence[0] = 0.0f;
+            for (int i = 1; i < MAX_VALENCE_LOOKUP; ++i)
+                valence[i] = VALENCE_BOOST_SCALE * std::pow((float)i, -VALENCE_BOOST_POWER);
+        }
+    };
+
+    float vertexScore(const ScoreTables& tables, int cachePosition, uint32_t liveTriangles)
+    {
+        if (liveTriangles == 0)
+            return -1.0f;
+        float score = cachePosition >= 0 ? tables.cache[cachePosition] : 0.0f;
+        if (liveTriangles < (uint32_t)MAX_VALENCE_LOOKUP)
+            return score + tables.valence[liveTriangles];
+        return score + VALENCE_BOOST_SCALE * std::pow((float)liveTriangles, -VALENCE_BOOST_POWER);
+    }
+}
+
+VertexCacheStats analyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize)
+{
+    VertexCacheStats stats;
+    if (indexCount < 3 || vertexCount == 0)
+        return stats;
+
+    // FIFO: enteredAt is the miss count just after a vertex was pushed (0 =
+    // never), and it is evicted once cacheSize later misses have pushed others
+    std::vector<uint32_t> enteredAt(vertexCount, 0);
+    std::vector<uint8_t> referenced(vertexCount, 0);
+    uint32_t misses = 0;
+    size_t unique = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        uint32_t v = indices[i];
+        if (!referenced[v]) {
+            referenced[v] = 1;
+            ++unique;
+        }
+        if (enteredAt[v] == 0 || misses - enteredAt[v] >= cacheSize) {
+            ++misses;
+            enteredAt[v] = misses;
+        }
+    }
+    stats.acmr = (float)misses / (float)(indexCount / 3);
+    stats.atvr = (float)misses / (float)unique;
+    return stats;
+}
+
+void optimizeVertexCache(uint32_t* dst, const uint32_t* indices, size_t indexCount, size_t vertexCount)
+{
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return;
+    static const ScoreTables tables;
+
+    // Vertex -> triangle adjacency in one flat array
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+        ++liveTriangles[indices[i]];
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + liveTriangles[v];
+    std::vector<uint32_t> adjacency(adjacencyOffset[vertexCount]);
+    std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        for (int k = 0; k < 3; ++k)
+            adjacency[fill[indices[t * 3 + k]]++] = (uint32_t)t;
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> score(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        score[v] = vertexScore(tables, -1, liveTriangles[v]);
+    std::vector<float> triangleScore(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t)
+        triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+    std::vector<uint8_t> emitted(triangleCount, 0);
+
+    std::vector<uint32_t> output(triangleCount * 3);
+    uint32_t cache[LRU_CACHE_SIZE + 3];
+    int cacheCount = 0;
+    size_t scanCursor = 0;
+
+    int64_t best = -1;
+    for (size_t written = 0; written < triangleCount; ++written) {
+        if (best < 0) {
+            // No candidate in the cache: take the next untouched triangle
+            while (emitted[scanCursor])
+                ++scanCursor;
+            best = (int64_t)scanCursor;
+        }
+
+        const uint32_t* tri = indices + best * 3;
+        std::memcpy(&output[written * 3], tri, 3 * sizeof(uint32_t));
+        emitted[best] = 1;
+
+        // Move the triangle's vertices to the front of the LRU
+        uint32_t newCache[LRU_CACHE_SIZE + 3];
+        int newCount = 0;
+        for (int k = 0; k < 3; ++k)
+            newCache[newCount++] = tri[k];
+        for (int i = 0; i < cacheCount; ++i) {
+            uint32_t v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                newCache[newCount++] = v;
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            uint32_t v = tri[k];
+            uint32_t* begin = &adjacency[adjacencyOffset[v]];
+            uint32_t* end = begin + liveTriangles[v];
+            std::iter_swap(std::find(begin, end, (uint32_t)best), end - 1);
+            --liveTriangles[v];
+        }
+
+        // Rescore everything that was or is in the cache and pick the best live triangle
+        for (int i = 0; i < newCount; ++i) {
+            uint32_t v = newCache[i];
+            int position = i < LRU_CACHE_SIZE ? i : -1;
+            cachePosition[v] = position;
+            float newScore = vertexScore(tables, position, liveTriangles[v]);
+            float delta = newScore - score[v];
+            score[v] = newScore;
+            for (uint32_t a = 0; a < liveTriangles[v]; ++a)
+                triangleScore[adjacency[adjacencyOffset[v] + a]] += delta;
+        }
+        cacheCount = std::min(newCount, LRU_CACHE_SIZE);
+        std::memcpy(cache, newCache, cacheCount * sizeof(uint32_t));
+
+        best = -1;
+        float bestScore = -1.0f;
+        for (int i = 0; i < cacheCount; ++i) {
+            uint32_t v = cache[i];
+            for (uint32_t a = 0; a < liveTriangles[v]; ++a) {
+                uint32_t t = adjacency[adjacencyOffset[v] + a];
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+    }
+    std::memcpy(dst, output.data(), output.size() * sizeof(uint32_t));
+}
+
+void optimizeOverdraw(uint32_t* dst, const uint32_t* indices, size_t indexCount,
+                      const Vertex* vertices, size_t vertexCount, float threshold)
+{
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return;
+
+    // 1) Cluster boundaries: hard where all three vertices miss the cache,
+    //    soft once the running cluster, simulated with a cold cache so it can
+    //    be moved anywhere, is within the ACMR budget
+    const float targetAcmr = analyzeVertexCache(indices, indexCount, vertexCount).acmr * threshold;
+    std::vector<uint32_t> enteredAt(vertexCount, 0);
+    std::vector<size_t> clusterStart;
+    uint32_t misses = 0, clusterBase = 0;
+    size_t clusterTriangles = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        int warmMisses = 0;
+        for (int k = 0; k < 3; ++k) {
+            uint32_t entered = enteredAt[indices[t * 3 + k]];
+            if (entered == 0 || misses - entered >= DEFAULT_FIFO_CACHE_SIZE)
+                ++warmMisses;
+        }
+        bool soft = clusterTriangles > 0
+            && (float)(misses - clusterBase) / (float)clusterTriangles <= targetAcmr;
+        if (t == 0 || warmMisses == 3 || soft) {
+            clusterStart.push_back(t);
+            clusterBase = misses;
+            clusterTriangles = 0;
+        }
+
+        // Entries from before the cluster start count as cold
+        for (int k = 0; k < 3; ++k) {
+            uint32_t& entered = enteredAt[indices[t * 3 + k]];
+            if (entered <= clusterBase || misses - entered >= DEFAULT_FIFO_CACHE_SIZE) {
+                ++misses;
+                entered = misses;
+            }
+        }
+        ++clusterTriangles;
+    }
+    clusterStart.push_back(triangleCount);
+
+    // 2) Sort key per cluster: how far its area-weighted centroid lies along
+    //    its own average normal, measured from the mesh centroid
+    const size_t clusterCount = clusterStart.size() - 1;
+    std::vector<glm::vec3> centroid(clusterCount, glm::vec3(0.0f)), normal(clusterCount, glm::vec3(0.0f));
+    std::vector<float> area(clusterCount, 0.0f);
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusterCount; ++c) {
+        for (size_t t = clusterStart[c]; t < clusterStart[c + 1]; ++t) {
+            const glm::vec3& a = vertices[indices[t * 3]].position;
+            const glm::vec3& b = vertices[indices[t * 3 + 1]].position;
+            const glm::vec3& d = vertices[indices[t * 3 + 2]].position;
+            glm::vec3 n = glm::cross(b - a, d - a);   // length is twice the area
+            float twiceArea = glm::length(n);
+            centroid[c] += (a + b + d) * (twiceArea / 3.0f);
+            normal[c] += n;
+            area[c] += twiceArea;
+        }
+        meshCentroid += centroid[c];
+        meshArea += area[c];
+    }
+    meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : glm::vec3(0.0f);
+
+    std::vector<float> sortKey(clusterCount, 0.0f);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        if (area[c] <= 0.0f)
+            continue;
+        float normalLength = glm::length(normal[c]);
+        if (normalLength > 0.0f)
+            sortKey[c] = glm::dot(centroid[c] / area[c] - meshCentroid, normal[c] / normalLength);
+    }
+
+    std::vector<uint32_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKey[a] > sortKey[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+    for (uint32_t c : order)
+        output.insert(output.end(), indices + clusterStart[c] * 3, indices + clusterStart[c + 1] * 3);
+    std::memcpy(dst, output.data(), output.size() * sizeof(uint32_t));
+}
+
+size_t optimizeVertexFetch(Vertex* vertices, uint32_t* indices, size_t indexCount, size_t vertexCount)
+{
+    const uint32_t UNUSED = 0xFFFFFFFFu;
+    std::vector<uint32_t> remap(vertexCount, UNUSED);
+    uint32_t next = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        uint32_t& slot = remap[indices[i]];
+        if (slot == UNUSED)
+            slot = next++;
+        indices[i] = slot;
+    }
+
+    std::vector<Vertex> reordered(next);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        if (remap[v] != UNUSED)
+            reordered[remap[v]] = vertices[v];
+    }
+    std::copy(reordered.begin(), reordered.end(), vertices);
+    return next;
+}
+
+MeshOptimizationReport optimizeModel(ModelData& model)
+{
+    MeshOptimizationReport report;
+    std::vector<Vertex> vertices;
+    vertices.reserve(model.vertices.size());
+    float trianglesTotal = 0.0f;
+
+    for (SubMeshData& sub : model.subMeshes) {
+        Vertex* subVertices = model.vertices.data() + sub.baseVertex;
+        uint32_t* subIndices = model.indices.data() + sub.firstIndex;
+        float triangles = (float)(sub.indexCount / 3);
+
+        VertexCacheStats before = analyzeVertexCache(subIndices, sub.indexCount, sub.vertexCount);
+        optimizeVertexCache(subIndices, subIndices, sub.indexCount, sub.vertexCount);
+        optimizeOverdraw(subIndices, subIndices, sub.indexCount, subVertices, sub.vertexCount);
+        size_t used = optimizeVertexFetch(subVertices, subIndices, sub.indexCount, sub.vertexCount);
+        VertexCacheStats after = analyzeVertexCache(subIndices, sub.indexCount, used);
+
+        // Repack without the vertices that were dropped
+        int32_t newBase = (int32_t)vertices.size();
+        vertices.insert(vertices.end(), subVertices, subVertices + used);
+        sub.baseVertex = newBase;
+        sub.vertexCount = (uint32_t)used;
+
+        report.before.acmr += before.acmr * triangles;
+        report.before.atvr += before.atvr * triangles;
+        report.after.acmr += after.acmr * triangles;
+        report.after.atvr += after.atvr * triangles;
+        trianglesTotal += triangles;
+    }
+    model.vertices.swap(vertices);
+
+    if (trianglesTotal > 0.0f) {
+        report.before.acmr /= trianglesTotal;
+        report.before.atvr /= trianglesTotal;
+        report.after.acmr /= trianglesTotal;
+        report.after.atvr /= trianglesTotal;
+    }
+    return report;
+}
@@ -0,0 +1,339 @@
+/* MeshSimplifier.cpp */
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    // Sum of squared distances to a set of planes, weighted per plane:
+    // error(p) = p'Ap + 2b'p + c
+    struct Quadric {
+        double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+        double b0 = 0, b1 = 0, b2 = 0;
+        double c = 0;
+        double weight = 0;
+
+        void addPlane(const glm::vec3& n, float d, float w)
+        {
+            a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z;
+            a11 += w * n.y * n.y; a12 += w * n.y * n.z; a22 += w * n.z * n.z;
+            b0 += w * n.x * d; b1 += w * n.y * d; b2 += w * n.z * d;
+            c += w * d * d;
+            weight += w;
+        }
+
+        void add(const Quadric& q)
+        {
+            a00 += q.a00; a01 += q.a01; a02 += q.a02; a11 += q.a11; a12 += q.a12; a22 += q.a22;
+            b0 += q.b0; b1 += q.b1; b2 += q.b2;
+            c += q.c;
+            weight += q.weight;
+        }
+
+        double evaluate(const glm::vec3& p) const
+        {
+            double x = p.x, y = p.y, z = p.z;
+            double e = x * (a00 * x + a01 * y + a02 * z)
+                     + y * (a01 * x + a11 * y + a12 * z)
+                     + z * (a02 * x + a12 * y + a22 * z)
+                     + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+            return std::max(e, 0.0);
+        }
+    };
+
+    // Area-weighted RMS distance of p to the planes of both quadrics; ranks
+    // collapses, since it favours keeping large triangles in place
+    float collapseError(const Quadric& a, const Quadric& b, const glm::vec3& p)
+    {
+        Quadric q = a;
+        q.add(b);
+        return q.weight > 0.0 ? (float)std::sqrt(q.evaluate(p) / q.weight) : 0.0f;
+    }
+
+    // Upper bound on the largest distance of p to any plane of two unit-weight
+    // quadrics: no single squared distance exceeds their sum
+    float distanceBound(const Quadric& a, const Quadric& b, const glm::vec3& p)
+    {
+        return (float)std::sqrt(a.evaluate(p) + b.evaluate(p));
+    }
+
+    struct PositionHash {
+        size_t operator()(const glm::vec3& p) const
+        {
+            uint32_t words[3];
+            std::memcpy(words, &p, sizeof(words));
+            size_t h = 2166136261u;
+            for (uint32_t w : words)
+                h = (h ^ w) * 16777619u;
+            return h;
+        }
+    };
+
+    struct Collapse {
+        uint32_t from;    // vertex that disappears
+        uint32_t to;      // vertex it merges into
+        float    error;   // ranking, see collapseError()
+        float    bound;   // see distanceBound()
+    };
+
+    const uint32_t NO_VERTEX = 0xFFFFFFFFu;
+}
+
+size_t simplifyMesh(uint32_t* dst, const uint32_t* indices, size_t indexCount,
+                    const Vertex* vertices, size_t vertexCount,
+                    size_t targetIndexCount, float maxError, float* resultError)
+{
+    std::vector<uint32_t> result(indices, indices + indexCount);
+    float error = 0.0f;
+
+    // 1) Vertices that share a position (UV or normal seams) form one point;
+    //    each of them is one of the point's wedges
+    std::vector<uint32_t> point(vertexCount);
+    std::vector<uint32_t> wedges;
+    {
+        std::unordered_map<glm::vec3, uint32_t, PositionHash> lookup;
+        lookup.reserve(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            auto it = lookup.emplace(vertices[v].position, (uint32_t)wedges.size()).first;
+            if (it->second == wedges.size())
+                wedges.push_back(0);
+            point[v] = it->second;
+            ++wedges[it->second];
+        }
+    }
+    const size_t pointCount = wedges.size();
+    std::vector<uint32_t> wedgeOffset(pointCount + 1, 0), wedgeVertices(vertexCount);
+    for (size_t p = 0; p < pointCount; ++p)
+        wedgeOffset[p + 1] = wedgeOffset[p] + wedges[p];
+    {
+        std::vector<uint32_t> fill(wedgeOffset.begin(), wedgeOffset.end() - 1);
+        for (size_t v = 0; v < vertexCount; ++v)
+            wedgeVertices[fill[point[v]]++] = (uint32_t)v;
+    }
+
+    // 2) Lock open borders, non-manifold edges and points where three or more
+    //    wedges meet (seam corners); an edge shared by exactly two triangles is
+    //    the only one safe to fold away. Two-wedge seam points stay free but
+    //    may only slide along their seam, see step 4.
+    std::vector<uint8_t> locked(pointCount, 0);
+    for (size_t p = 0; p < pointCount; ++p)
+        locked[p] = wedges[p] > 2;
+    {
+        std::unordered_map<uint64_t, uint32_t> edgeUses;
+        edgeUses.reserve(indexCount);
+        for (size_t i = 0; i < indexCount; i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                uint64_t a = point[result[i + k]], b = point[result[i + (k + 1) % 3]];
+                ++edgeUses[a < b ? (a << 32 | b) : (b << 32 | a)];
+            }
+        }
+        for (const auto& edge : edgeUses) {
+            if (edge.second != 2) {
+                locked[edge.first >> 32] = 1;
+                locked[edge.first & 0xFFFFFFFFu] = 1;
+            }
+        }
+    }
+
+    // 3) Accumulate triangle planes per point, area weighted for ranking and
+    //    unit weighted for the error bound
+    std::vector<Quadric> quadrics(pointCount), bounds(pointCount);
+    for (size_t i = 0; i < indexCount; i += 3) {
+        const glm::vec3& p0 = vertices[result[i]].position;
+        glm::vec3 n = glm::cross(vertices[result[i + 1]].position - p0, vertices[result[i + 2]].position - p0);
+        float twiceArea = glm::length(n);
+        if (twiceArea <= 0.0f)
+            continue;
+        n /= twiceArea;
+        float d = -glm::dot(n, p0);
+        for (int k = 0; k < 3; ++k) {
+            quadrics[point[result[i + k]]].addPlane(n, d, twiceArea * 0.5f);
+            bounds[point[result[i + k]]].addPlane(n, d, 1.0f);
+        }
+    }
+
+    // 4) Collapse in passes: rank every candidate edge, then greedily take the
+    //    cheapest ones whose neighbourhoods do not overlap within the pass
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1), adjacency, fill;
+    std::vector<Collapse> candidates;
+    std::vector<uint32_t> collapseTo(vertexCount);
+    std::vector<uint8_t> passLocked(pointCount);
+    std::vector<uint32_t> wedgeTargets;
+
+    while (result.size() > targetIndexCount) {
+        const size_t triangleCount = result.size() / 3;
+
+        std::fill(adjacencyOffset.begin(), adjacencyOffset.end(), 0u);
+        for (uint32_t v : result)
+            ++adjacencyOffset[v + 1];
+        for (size_t v = 0; v < vertexCount; ++v)
+            adjacencyOffset[v + 1] += adjacencyOffset[v];
+        adjacency.resize(result.size());
+        fill.assign(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (int k = 0; k < 3; ++k)
+                adjacency[fill[result[t * 3 + k]]++] = (uint32_t)t;
+        }
+
+        candidates.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                uint32_t a = result[i + k], b = result[i + (k + 1) % 3];
+                const uint32_t pa = point[a], pb = point[b];
+                if (!locked[pa])
+                    candidates.push_back({ a, b, collapseError(quadrics[pa], quadrics[pb], vertices[b].position),
+                                           distanceBound(bounds[pa], bounds[pb], vertices[b].position) });
+                if (!locked[pb])
+                    candidates.push_back({ b, a, collapseError(quadrics[pb], quadrics[pa], vertices[a].position),
+                                           distanceBound(bounds[pb], bounds[pa], vertices[a].position) });
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Collapse& x, const Collapse& y) { return x.error < y.error; });
+
+        for (size_t v = 0; v < vertexCount; ++v)
+            collapseTo[v] = (uint32_t)v;
+        std::fill(passLocked.begin(), passLocked.end(), 0);
+
+        // Each interior collapse removes two triangles
+        size_t removable = (result.size() - targetIndexCount) / 6 + 1;
+        size_t collapses = 0;
+        for (const Collapse& c : candidates) {
+            if (collapses >= removable)
+                break;
+            uint32_t from = point[c.from], to = point[c.to];
+            if (passLocked[from] || passLocked[to] || c.bound > maxError)
+                continue;
+
+            // Every wedge of the point moves onto the one wedge of the target
+            // point it shares triangles with. For a seam point that only
+            // exists when the edge runs along the seam, so each side of the
+            // seam keeps its own attributes.
+            bool mapped = true;
+            wedgeTargets.clear();
+            for (uint32_t w = wedgeOffset[from]; w < wedgeOffset[from + 1] && mapped; ++w) {
+                uint32_t v = wedgeVertices[w], target = NO_VERTEX;
+                for (uint32_t a = adjacencyOffset[v]; a < adjacencyOffset[v + 1]; ++a) {
+                    const uint32_t* tri = &result[adjacency[a] * 3];
+                    for (int k = 0; k < 3; ++k) {
+                        if (point[tri[k]] != to)
+                            continue;
+                        mapped &= target == NO_VERTEX || target == tri[k];
+                        target = tri[k];
+                    }
+                }
+                // Wedges whose triangles are all gone have nothing to move
+                if (adjacencyOffset[v] != adjacencyOffset[v + 1])
+                    mapped &= target != NO_VERTEX;
+                wedgeTargets.push_back(target);
+            }
+            if (!mapped)
+                continue;
+
+            // Reject collapses that would flip a surviving triangle
+            bool flips = false;
+            const glm::vec3& target = vertices[c.to].position;
+            for (uint32_t w = wedgeOffset[from]; w < wedgeOffset[from + 1] && !flips; ++w) {
+                uint32_t v = wedgeVertices[w];
+                for (uint32_t a = adjacencyOffset[v]; a < adjacencyOffset[v + 1] && !flips; ++a) {
+                    const uint32_t* tri = &result[adjacency[a] * 3];
+                    if (point[tri[0]] == to || point[tri[1]] == to || point[tri[2]] == to)
+                        continue;
+                    glm::vec3 p[3], q[3];
+                    for (int k = 0; k < 3; ++k) {
+                        p[k] = vertices[tri[k]].position;
+                        q[k] = point[tri[k]] == from ? target : p[k];
+                    }
+                    glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                    glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+                    // Tilting a normal by more than ~60 degrees also counts, or
+                    // successive passes can fold a triangle a little at a time
+                    flips = glm::dot(before, after) <= 0.5f * glm::length(before) * glm::length(after);
+                }
+            }
+            if (flips)
+                continue;
+
+            for (uint32_t w = wedgeOffset[from]; w < wedgeOffset[from + 1]; ++w) {
+                if (wedgeTargets[w - wedgeOffset[from]] != NO_VERTEX)
+                    collapseTo[wedgeVertices[w]] = wedgeTargets[w - wedgeOffset[from]];
+            }
+            quadrics[to].add(quadrics[from]);
+            bounds[to].add(bounds[from]);
+            error = std::max(error, c.bound);
+            ++collapses;
+
+            // Freeze the one-ring so later collapses in this pass see current geometry
+            passLocked[to] = 1;
+            for (uint32_t w = wedgeOffset[from]; w < wedgeOffset[from + 1]; ++w) {
+                uint32_t v = wedgeVertices[w];
+                for (uint32_t a = adjacencyOffset[v]; a < adjacencyOffset[v + 1]; ++a) {
+                    const uint32_t* tri = &result[adjacency[a] * 3];
+                    for (int k = 0; k < 3; ++k)
+                        passLocked[point[tri[k]]] = 1;
+                }
+            }
+        }
+        if (collapses == 0)
+            break;
+
+        // Apply the collapses and drop triangles that became degenerate
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            uint32_t a = collapseTo[result[i]], b = collapseTo[result[i + 1]], c = collapseTo[result[i + 2]];
+            if (point[a] == point[b] || point[b] == point[c] || point[a] == point[c])
+                continue;
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    std::copy(result.begin(), result.end(), dst);
+    if (resultError)
+        *resultError = error;
+    return result.size();
+}
+
+void buildLodChain(ModelData& model)
+{
+    model.lods.clear();
+    for (uint32_t s = 0; s < (uint32_t)model.subMeshes.size(); ++s) {
+        const SubMeshData& sub = model.subMeshes[s];
+        const Vertex* vertices = model.vertices.data() + sub.baseVertex;
+        // Copy out; appending levels may reallocate model.indices
+        std::vector<uint32_t> source(model.indices.begin() + sub.firstIndex,
+                                     model.indices.begin() + sub.firstIndex + sub.indexCount);
+        std::vector<uint32_t> level(source.size());
+
+        // Each level simplifies the previous one and reports a bound on how
+        // far its collapsed vertices lie from that level's triangle planes;
+        // summing the bounds keeps lod.error an upper bound relative to full detail
+        float previousError = 0.0f;
+        for (uint32_t l = 1; l < MAX_LOD_LEVELS; ++l) {
+            size_t target = (source.size() / 6) * 3;
+            float levelError = 0.0f;
+            size_t count = simplifyMesh(level.data(), source.data(), source.size(), vertices, sub.vertexCount,
+                                        target, std::numeric_limits<float>::max(), &levelError);
+            if (count == 0 || count > source.size() * 85 / 100)
+                break;
+            optimizeVertexCache(level.data(), level.data(), count, sub.vertexCount);
+
+            LodData lod;
+            lod.subMesh = s;
+            lod.firstIndex = (uint32_t)model.indices.size();
+            lod.indexCount = (uint32_t)count;
+            lod.error = previousError + levelError;
+            model.indices.insert(model.indices.end(), level.begin(), level.begin() + count);
+            model.lods.push_back(lod);
+            source.assign(level.begin(), level.begin() + count);
+            previousError = lod.error;
+        }
+    }
+}
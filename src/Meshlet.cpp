@@ -0,0 +1,176 @@
+/* Meshlet.cpp */
+#include "Meshlet.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const uint8_t NOT_IN_MESHLET = 0xFF;
+
+    MeshletBounds computeBounds(const MeshletData& data, const Meshlet& meshlet, const Vertex* vertices)
+    {
+        MeshletBounds bounds;
+        const uint32_t* local = &data.vertices[meshlet.vertexOffset];
+
+        // Sphere around the box center; cheap and close enough for small clusters
+        glm::vec3 bmin(vertices[local[0]].position), bmax(bmin);
+        for (uint32_t i = 1; i < meshlet.vertexCount; ++i) {
+            bmin = glm::min(bmin, vertices[local[i]].position);
+            bmax = glm::max(bmax, vertices[local[i]].position);
+        }
+        bounds.center = (bmin + bmax) * 0.5f;
+        float radiusSq = 0.0f;
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+            glm::vec3 d = vertices[local[i]].position - bounds.center;
+            radiusSq = std::max(radiusSq, glm::dot(d, d));
+        }
+        bounds.radius = std::sqrt(radiusSq);
+
+        // Normal cone: mean face direction and the widest deviation from it
+        const uint8_t* tris = &data.triangles[meshlet.triangleOffset];
+        std::vector<glm::vec3> normals;
+        normals.reserve(meshlet.triangleCount);
+        glm::vec3 sum(0.0f);
+        for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+            const glm::vec3& p0 = vertices[local[tris[t * 3]]].position;
+            const glm::vec3& p1 = vertices[local[tris[t * 3 + 1]]].position;
+            const glm::vec3& p2 = vertices[local[tris[t * 3 + 2]]].position;
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            float length = glm::length(n);
+            if (length <= 0.0f)
+                continue;
+            normals.push_back(n / length);
+            sum += normals.back();
+        }
+
+        bounds.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+        bounds.coneCutoff = 1.0f;
+        float sumLength = glm::length(sum);
+        if (sumLength <= 1e-6f)
+            return bounds;
+        bounds.coneAxis = sum / sumLength;
+        float minDot = 1.0f;
+        for (const glm::vec3& n : normals)
+            minDot = std::min(minDot, glm::dot(n, bounds.coneAxis));
+        // A cone wider than a hemisphere can always see some front face
+        if (minDot > 0.0f)
+            bounds.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+        return bounds;
+    }
+}
+
+void buildMeshlets(MeshletData& out, const uint32_t* indices, size_t indexCount,
+                   const Vertex* vertices, size_t vertexCount,
+                   size_t maxVertices, size_t maxTriangles)
+{
+    // Local corners are bytes
+    maxVertices = std::min<size_t>(std::max<size_t>(maxVertices, 3), 255);
+    maxTriangles = std::max<size_t>(maxTriangles, 1);
+
+    out = MeshletData();
+    std::vector<uint8_t> localIndex(vertexCount, NOT_IN_MESHLET);
+    Meshlet current{ 0, 0, 0, 0 };
+
+    auto flush = [&]() {
+        if (current.triangleCount == 0)
+            return;
+        out.meshlets.push_back(current);
+        out.bounds.push_back(computeBounds(out, current, vertices));
+        for (uint32_t i = 0; i < current.vertexCount; ++i)
+            localIndex[out.vertices[current.vertexOffset + i]] = NOT_IN_MESHLET;
+        current = Meshlet{ (uint32_t)out.vertices.size(), (uint32_t)out.triangles.size(), 0, 0 };
+    };
+
+    for (size_t i = 0; i + 2 < indexCount; i += 3) {
+        const uint32_t* tri = indices + i;
+        size_t newVertices = (localIndex[tri[0]] == NOT_IN_MESHLET)
+                           + (localIndex[tri[1]] == NOT_IN_MESHLET && tri[1] != tri[0])
+                           + (localIndex[tri[2]] == NOT_IN_MESHLET && tri[2] != tri[0] && tri[2] != tri[1]);
+        if (current.vertexCount + newVertices > maxVertices || current.triangleCount + 1 > maxTriangles)
+            flush();
+
+        for (int k = 0; k < 3; ++k) {
+            uint32_t v = tri[k];
+            if (localIndex[v] == NOT_IN_MESHLET) {
+                localIndex[v] = (uint8_t)current.vertexCount++;
+                out.vertices.push_back(v);
+            }
+            out.triangles.push_back(localIndex[v]);
+        }
+        ++current.triangleCount;
+    }
+    flush();
+}
+
+size_t cullMeshlets(const MeshletData& data, const glm::mat4& transform, const glm::vec3& viewPosition,
+                    const Frustum& frustum, std::vector<uint32_t>& visible)
+{
+    // Facing and plane side are invariant under an affine map, so bring the
+    // eye and the planes to model space instead of moving every bound out
+    const Frustum local = frustum.transformed(transform);
+    const glm::vec3 eye = glm::vec3(glm::inverse(transform) * glm::vec4(viewPosition, 1.0f));
+
+    visible.clear();
+    for (size_t i = 0; i < data.bounds.size(); ++i) {
+        const MeshletBounds& b = data.bounds[i];
+        if (!local.intersectsSphere(b.center, b.radius))
+            continue;
+        // Back-facing when every normal in the cone points away from every
+        // point of the sphere as seen from the eye
+        glm::vec3 toCenter = b.center - eye;
+        if (glm::dot(toCenter, b.coneAxis) >= b.coneCutoff * glm::length(toCenter) + b.radius)
+            continue;
+        visible.push_back((uint32_t)i);
+    }
+    return visible.size();
+}
+
+//------------------------------------------------------------------------------
+// MeshletStream
+void MeshletStream::create()
+{
+    glGenBuffers(1, &m_ebo);
+}
+
+void MeshletStream::attachTo(unsigned int vao) const
+{
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    glBindVertexArray(0);
+}
+
+MeshletDraw MeshletStream::append(const MeshletData& data, const uint32_t* visible, size_t count)
+{
+    MeshletDraw run;
+    run.firstIndex = (uint32_t)m_indices.size();
+    for (size_t i = 0; i < count; ++i) {
+        const Meshlet& m = data.meshlets[visible[i]];
+        const uint32_t* local = &data.vertices[m.vertexOffset];
+        const uint8_t* tris = &data.triangles[m.triangleOffset];
+        for (uint32_t c = 0; c < m.triangleCount * 3; ++c)
+            m_indices.push_back(local[tris[c]]);
+    }
+    run.indexCount = (uint32_t)m_indices.size() - run.firstIndex;
+    return run;
+}
+
+void MeshletStream::upload()
+{
+    // The copy target avoids touching whichever VAO is currently bound
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_ebo);
+    if (m_indices.size() > m_capacity)
+        m_capacity = std::max(m_indices.size(), m_capacity * 2);
+    // Orphan the old storage, then fill the new one
+    glBufferData(GL_COPY_WRITE_BUFFER, m_capacity * sizeof(uint32_t), nullptr, GL_STREAM_DRAW);
+    if (!m_indices.empty())
+        glBufferSubData(GL_COPY_WRITE_BUFFER, 0, m_indices.size() * sizeof(uint32_t), m_indices.data());
+}
+
+void MeshletStream::release()
+{
+    if (m_ebo != 0)
+        glDeleteBuffers(1, &m_ebo);
+    m_ebo = 0;
+    m_capacity = 0;
+    m_indices.clear();
+}
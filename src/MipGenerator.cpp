@@ -0,0 +1,234 @@
+/* MipGenerator.cpp */
+#include "MipGenerator.h"
+#include "CpuFeatures.h"
+#include "MipGeneratorAvx.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIP_GENERATOR_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Downsampling kernel: output texel x reads source texels 2x + offset
+    struct Kernel {
+        int   taps;
+        int   firstOffset;
+        float weights[6];
+    };
+
+    // Zeroth-order modified Bessel function of the first kind
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    Kernel makeKernel(MipFilter filter)
+    {
+        if (filter == MipFilter::Box)
+            return Kernel{ 2, 0, { 0.5f, 0.5f } };
+
+        // Half-band sinc windowed by Kaiser (alpha 4) over a radius of 3 source texels
+        const double PI = 3.14159265358979323846;
+        const double RADIUS = 3.0, ALPHA = 4.0;
+        Kernel kernel{ 6, -2, {} };
+        double total = 0.0;
+        for (int i = 0; i < 6; ++i) {
+            double d = (kernel.firstOffset + i) - 0.5;   // distance from the output texel centre
+            double x = d * 0.5;
+            double sinc = PI * x == 0.0 ? 1.0 : std::sin(PI * x) / (PI * x);
+            double r = d / RADIUS;
+            double window = besselI0(ALPHA * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(ALPHA);
+            kernel.weights[i] = (float)(sinc * window);
+            total += kernel.weights[i];
+        }
+        for (int i = 0; i < 6; ++i)
+            kernel.weights[i] = (float)(kernel.weights[i] / total);
+        return kernel;
+    }
+
+    struct SrgbTables {
+        float   toLinear[256];
+        uint8_t fromLinear[4096];
+
+        SrgbTables()
+        {
+            for (int i = 0; i < 256; ++i) {
+                float c = i / 255.0f;
+                toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (int i = 0; i < 4096; ++i) {
+                float l = i / 4095.0f;
+                float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                fromLinear[i] = (uint8_t)std::lround(std::min(std::max(c, 0.0f), 1.0f) * 255.0f);
+            }
+        }
+    };
+
+    const SrgbTables& srgbTables()
+    {
+        static const SrgbTables tables;
+        return tables;
+    }
+
+    // Float RGBA image; channels the source lacks are padded
+    struct FloatImage {
+        uint32_t           width = 0;
+        uint32_t           height = 0;
+        std::vector<float> texels;
+    };
+
+    FloatImage toFloat(const uint8_t* pixels, uint32_t width, uint32_t height, int components, bool srgb)
+    {
+        const SrgbTables& tables = srgbTables();
+        FloatImage image{ width, height, std::vector<float>((size_t)width * height * 4, 1.0f) };
+        for (size_t i = 0; i < (size_t)width * height; ++i) {
+            for (int c = 0; c < components; ++c) {
+                uint8_t v = pixels[i * components + c];
+                bool color = srgb && c < 3;
+                image.texels[i * 4 + c] = color ? tables.toLinear[v] : v / 255.0f;
+            }
+        }
+        return image;
+    }
+
+    MipLevel toBytes(const FloatImage& image, int components, bool srgb)
+    {
+        const SrgbTables& tables = srgbTables();
+        MipLevel level{ image.width, image.height, std::vector<uint8_t>((size_t)image.width * image.height * components) };
+        for (size_t i = 0; i < (size_t)image.width * image.height; ++i) {
+            for (int c = 0; c < components; ++c) {
+                float v = std::min(std::max(image.texels[i * 4 + c], 0.0f), 1.0f);
+                bool color = srgb && c < 3;
+                level.data[i * components + c] = color ? tables.fromLinear[(int)(v * 4095.0f + 0.5f)]
+                                                       : (uint8_t)(v * 255.0f + 0.5f);
+            }
+        }
+        return level;
+    }
+
+    // dst[x] = sum_k w_k * src[clamp(2x + offset_k)], one RGBA texel at a time
+    void filterRow(const float* src, uint32_t srcWidth, float* dst, uint32_t dstWidth, const Kernel& kernel)
+    {
+        for (uint32_t x = 0; x < dstWidth; ++x) {
+#ifdef MIP_GENERATOR_SSE
+            __m128 sum = _mm_setzero_ps();
+            for (int k = 0; k < kernel.taps; ++k) {
+                int sx = std::min(std::max((int)(2 * x) + kernel.firstOffset + k, 0), (int)srcWidth - 1);
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + sx * 4), _mm_set1_ps(kernel.weights[k])));
+            }
+            _mm_storeu_ps(dst + x * 4, sum);
+#else
+            float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            for (int k = 0; k < kernel.taps; ++k) {
+                int sx = std::min(std::max((int)(2 * x) + kernel.firstOffset + k, 0), (int)srcWidth - 1);
+                for (int c = 0; c < 4; ++c)
+                    sum[c] += src[sx * 4 + c] * kernel.weights[k];
+            }
+            std::memcpy(dst + x * 4, sum, sizeof(sum));
+#endif
+        }
+    }
+
+    // dst = sum_k w_k * rows[k], over count floats
+    void blendRows(const float* const* rows, const float* weights, int taps, float* dst, size_t count)
+    {
+        // Eight floats at a time where the CPU has AVX; SSE and scalar take the rest
+        size_t i = cpuSupportsAvx() ? blendRowsAvx(rows, weights, taps, dst, count) : 0;
+#ifdef MIP_GENERATOR_SSE
+        for (; i + 4 <= count; i += 4) {
+            __m128 sum = _mm_setzero_ps();
+            for (int k = 0; k < taps; ++k)
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(rows[k] + i), _mm_set1_ps(weights[k])));
+            _mm_storeu_ps(dst + i, sum);
+        }
+#endif
+        for (; i < count; ++i) {
+            float sum = 0.0f;
+            for (int k = 0; k < taps; ++k)
+                sum += rows[k][i] * weights[k];
+            dst[i] = sum;
+        }
+    }
+
+    FloatImage downsample(const FloatImage& src, const Kernel& kernel)
+    {
+        FloatImage dst;
+        dst.width = std::max(1u, src.width / 2);
+        dst.height = std::max(1u, src.height / 2);
+        dst.texels.resize((size_t)dst.width * dst.height * 4);
+
+        // A dimension that is already 1 is copied instead of filtered
+        const Kernel identity{ 1, 0, { 1.0f } };
+        const Kernel& horizontal = src.width > 1 ? kernel : identity;
+        const Kernel& vertical = src.height > 1 ? kernel : identity;
+
+        // Horizontal pass into a half-width intermediate, then vertical
+        std::vector<float> rows((size_t)dst.width * src.height * 4);
+        for (uint32_t y = 0; y < src.height; ++y)
+            filterRow(&src.texels[(size_t)y * src.width * 4], src.width, &rows[(size_t)y * dst.width * 4], dst.width, horizontal);
+
+        const size_t rowFloats = (size_t)dst.width * 4;
+        const float* taps[6];
+        for (uint32_t y = 0; y < dst.height; ++y) {
+            for (int k = 0; k < vertical.taps; ++k) {
+                int sy = std::min(std::max((int)(2 * y) + vertical.firstOffset + k, 0), (int)src.height - 1);
+                taps[k] = &rows[(size_t)sy * rowFloats];
+            }
+            blendRows(taps, vertical.weights, vertical.taps, &dst.texels[(size_t)y * rowFloats], rowFloats);
+        }
+        return dst;
+    }
+
+    // Map each texel to [-1, 1] XYZ, rescale to unit length and map back
+    void renormalize(FloatImage& image)
+    {
+        for (size_t i = 0; i < (size_t)image.width * image.height; ++i) {
+            float* t = &image.texels[i * 4];
+            float x = t[0] * 2.0f - 1.0f, y = t[1] * 2.0f - 1.0f, z = t[2] * 2.0f - 1.0f;
+            float length = std::sqrt(x * x + y * y + z * z);
+            if (length < 1e-6f)
+                continue;
+            float scale = 0.5f / length;
+            t[0] = x * scale + 0.5f;
+            t[1] = y * scale + 0.5f;
+            t[2] = z * scale + 0.5f;
+        }
+    }
+}
+
+std::vector<MipLevel> generateMipChain(const uint8_t* pixels, uint32_t width, uint32_t height,
+                                       int components, const MipOptions& options)
+{
+    std::vector<MipLevel> levels;
+    if (!pixels || width == 0 || height == 0 || components < 1 || components > 4)
+        return levels;
+
+    levels.push_back(MipLevel{ width, height, std::vector<uint8_t>(pixels, pixels + (size_t)width * height * components) });
+    if (width == 1 && height == 1)
+        return levels;
+
+    // Normal maps store directions, never sRGB colors
+    const bool srgb = options.srgb && !options.normalMap;
+    const bool normalMap = options.normalMap && components >= 3;
+    const Kernel kernel = makeKernel(options.filter);
+
+    // Each level is filtered from the previous float level, so quantization
+    // error does not accumulate down the chain
+    FloatImage level = toFloat(pixels, width, height, components, srgb);
+    while (level.width > 1 || level.height > 1) {
+        level = downsample(level, kernel);
+        if (normalMap)
+            renormalize(level);
+        levels.push_back(toBytes(level, components, srgb));
+    }
+    return levels;
+}
@@ -0,0 +1,27 @@
+/* MipGeneratorAvx.cpp */
+// Compiled with AVX enabled (see CMakeLists.txt); keep shared headers out
+#include "MipGeneratorAvx.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+
+size_t blendRowsAvx(const float* const* rows, const float* weights, int taps, float* dst, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 sum = _mm256_setzero_ps();
+        for (int k = 0; k < taps; ++k)
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(rows[k] + i), _mm256_set1_ps(weights[k])));
+        _mm256_storeu_ps(dst + i, sum);
+    }
+    return i;
+}
+
+#else
+
+size_t blendRowsAvx(const float* const*, const float*, int, float*, size_t)
+{
+    return 0;
+}
+
+#endif
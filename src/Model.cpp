@@ -0,0 +1,293 @@
+/* Model.cpp */
+#include "Model.h"
+#include "MeshCache.h"
+#include "Lod.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace {
+    // Part of the cache key, so changing them invalidates existing caches
+    const unsigned int IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs
+        | aiProcess_JoinIdenticalVertices | aiProcess_PreTransformVertices;
+
+    // Material libraries named by an OBJ's mtllib lines, relative to the OBJ
+    std::vector<std::string> materialLibraries(const std::string& path)
+    {
+        std::vector<std::string> libraries;
+        std::string extension = std::filesystem::path(path).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (extension != ".obj")
+            return libraries;
+
+        std::filesystem::path directory = std::filesystem::path(path).parent_path();
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream tokens(line);
+            std::string keyword, name;
+            if (!(tokens >> keyword) || keyword != "mtllib")
+                continue;
+            while (tokens >> name)
+                libraries.push_back((directory / name).string());
+        }
+        return libraries;
+    }
+
+    // Hash of the model file, its material libraries and the import flags;
+    // 0 if the model itself cannot be read. A missing library hashes as 0 so
+    // creating it later still invalidates the cache.
+    uint64_t sourceHashFor(const std::string& path)
+    {
+        uint64_t hash = hashFile(path);
+        if (hash == 0)
+            return 0;
+        for (const std::string& library : materialLibraries(path))
+            hash = hashCombine(hash, hashFile(library));
+        return hashCombine(hash, IMPORT_FLAGS);
+    }
+
+    std::string texturePath(const aiMaterial* material, aiTextureType type)
+    {
+        aiString path;
+        if (material->GetTextureCount(type) == 0 || material->GetTexture(type, 0, &path) != AI_SUCCESS)
+            return std::string();
+        return path.C_Str();
+    }
+}
+
+bool importModel(const std::string& path, ModelData& model)
+{
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(path, IMPORT_FLAGS);
+    if (!scene || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) || !scene->mRootNode) {
+        std::cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << std::endl;
+        return false;
+    }
+
+    model = ModelData();
+    for (unsigned int i = 0; i < scene->mNumMaterials; ++i) {
+        const aiMaterial* source = scene->mMaterials[i];
+        MaterialData material;
+        material.diffuse = texturePath(source, aiTextureType_DIFFUSE);
+        material.specular = texturePath(source, aiTextureType_SPECULAR);
+        // OBJ's map_Bump arrives as a height map
+        material.normal = texturePath(source, aiTextureType_NORMALS);
+        if (material.normal.empty())
+            material.normal = texturePath(source, aiTextureType_HEIGHT);
+        // OBJ without Ns reports 0, which would light every texel at full specular
+        float shininess = 0.0f;
+        if (source->Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS && shininess > 0.0f)
+            material.shininess = shininess;
+        model.materials.push_back(material);
+    }
+
+    model.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+    model.boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+    for (unsigned int m = 0; m < scene->mNumMeshes; ++m) {
+        const aiMesh* mesh = scene->mMeshes[m];
+        SubMeshData sub;
+        sub.firstIndex = (uint32_t)model.indices.size();
+        sub.baseVertex = (int32_t)model.vertices.size();
+        sub.vertexCount = mesh->mNumVertices;
+        sub.material = mesh->mMaterialIndex;
+        sub.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+        sub.boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+
+        for (unsigned int v = 0; v < mesh->mNumVertices; ++v) {
+            Vertex vertex;
+            vertex.position = glm::vec3(mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z);
+            vertex.normal = mesh->HasNormals()
+                ? glm::vec3(mesh->mNormals[v].x, mesh->mNormals[v].y, mesh->mNormals[v].z)
+                : glm::vec3(0.0f, 1.0f, 0.0f);
+            vertex.texCoords = mesh->HasTextureCoords(0)
+                ? glm::vec2(mesh->mTextureCoords[0][v].x, mesh->mTextureCoords[0][v].y)
+                : glm::vec2(0.0f);
+            sub.boundsMin = glm::min(sub.boundsMin, vertex.position);
+            sub.boundsMax = glm::max(sub.boundsMax, vertex.position);
+            model.vertices.push_back(vertex);
+        }
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+            const aiFace& face = mesh->mFaces[f];
+            if (face.mNumIndices != 3)
+                continue;   // points and lines left over after triangulation
+            model.indices.insert(model.indices.end(), face.mIndices, face.mIndices + 3);
+        }
+        sub.indexCount = (uint32_t)model.indices.size() - sub.firstIndex;
+        model.boundsMin = glm::min(model.boundsMin, sub.boundsMin);
+        model.boundsMax = glm::max(model.boundsMax, sub.boundsMax);
+        model.subMeshes.push_back(sub);
+    }
+    return !model.subMeshes.empty();
+}
+
+//------------------------------------------------------------------------------
+// Model
+std::string Model::cachePathFor(const std::string& path) const
+{
+    // The stem keeps the file recognizable; the path hash separates equal stems
+    std::error_code error;
+    std::string canonical = std::filesystem::weakly_canonical(path, error).generic_string();
+    std::ostringstream name;
+    name << std::filesystem::path(path).stem().string() << '-' << std::hex << (uint32_t)std::hash<std::string>()(canonical) << ".mesh";
+    return (std::filesystem::path(m_cacheDirectory) / name.str()).string();
+}
+
+bool Model::load(const std::string& path, MeshBuffer& meshes, TextureCache& textures, RenderQueue& queue)
+{
+    uint64_t sourceHash = sourceHashFor(path);
+    if (sourceHash == 0) {
+        std::cout << "Model failed to load at path: " << path << std::endl;
+        return false;
+    }
+
+    ModelData data;
+    std::string cachePath = cachePathFor(path);
+    m_loadedFromCache = readMeshCache(cachePath, sourceHash, data);
+    if (!m_loadedFromCache) {
+        if (!importModel(path, data))
+            return false;
+
+        // Optimize once at import; the cache stores the reordered result
+        MeshOptimizationReport report = optimizeModel(data);
+        std::cout << "Optimized " << path << ": ACMR " << report.before.acmr << " -> " << report.after.acmr
+                  << ", ATVR " << report.before.atvr << " -> " << report.after.atvr << std::endl;
+        buildLodChain(data);
+        std::error_code error;
+        std::filesystem::create_directories(m_cacheDirectory, error);
+        if (!writeMeshCache(cachePath, sourceHash, data))
+            std::cout << "Could not write mesh cache: " << cachePath << std::endl;
+    }
+
+    // Resolve each material's maps once; the cache shares them between models.
+    // Every material gets its own queue material and texture set, plus a
+    // default one for sub-meshes without a material.
+    std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    std::vector<uint32_t> materials, textureSets;
+    for (const MaterialData& material : data.materials) {
+        unsigned int diffuse = 0, specular = 0;
+        if (!material.diffuse.empty()) {
+            diffuse = textures.acquire((directory / material.diffuse).string());
+            m_textures.push_back(diffuse);
+        }
+        if (!material.specular.empty()) {
+            specular = textures.acquire((directory / material.specular).string());
+            m_textures.push_back(specular);
+        }
+        materials.push_back(queue.addMaterial(material.shininess));
+        textureSets.push_back(queue.addTextureSet(diffuse, specular));
+    }
+    if (materials.empty()) {
+        materials.push_back(queue.addMaterial(MaterialData().shininess));
+        textureSets.push_back(queue.addTextureSet(0, 0));
+    }
+
+    m_lodErrors.assign(1, 0.0f);
+    for (const SubMeshData& sub : data.subMeshes) {
+        DrawItem item;
+        item.levels.push_back(meshes.add(data.vertices.data() + sub.baseVertex, sub.vertexCount,
+                                         data.indices.data() + sub.firstIndex, sub.indexCount));
+        // Cheap to rebuild, so meshlets are not part of the mesh cache
+        buildMeshlets(item.meshlets, data.indices.data() + sub.firstIndex, sub.indexCount,
+                      data.vertices.data() + sub.baseVertex, sub.vertexCount);
+        size_t material = sub.material < materials.size() ? sub.material : 0;
+        item.material = materials[material];
+        item.textureSet = textureSets[material];
+        m_items.push_back(item);
+    }
+    // Levels reuse their sub-mesh's vertices; a level's error is the worst over sub-meshes
+    for (const LodData& lod : data.lods) {
+        DrawItem& item = m_items[lod.subMesh];
+        item.levels.push_back(meshes.addLod(item.levels[0], data.indices.data() + lod.firstIndex, lod.indexCount));
+        size_t level = item.levels.size() - 1;
+        if (level >= m_lodErrors.size())
+            m_lodErrors.resize(level + 1, 0.0f);
+        m_lodErrors[level] = std::max(m_lodErrors[level], lod.error);
+    }
+    // Sub-meshes with shorter chains stay at their last level, so keep errors monotonic
+    for (size_t l = 1; l < m_lodErrors.size(); ++l)
+        m_lodErrors[l] = std::max(m_lodErrors[l], m_lodErrors[l - 1]);
+    m_boundsMin = data.boundsMin;
+    m_boundsMax = data.boundsMax;
+    return true;
+}
+
+uint32_t Model::selectLod(const glm::mat4& transform, const glm::vec3& viewPosition,
+                          float projectionScale, float maxPixelError) const
+{
+    if (m_lodErrors.size() <= 1)
+        return 0;
+
+    // Distance to the transformed bounding sphere; errors scale with the largest axis
+    glm::vec3 center = glm::vec3(transform * glm::vec4((m_boundsMin + m_boundsMax) * 0.5f, 1.0f));
+    float scale = std::max(glm::length(glm::vec3(transform[0])),
+                           std::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+    float radius = glm::length(m_boundsMax - m_boundsMin) * 0.5f * scale;
+    float distance = glm::length(center - viewPosition) - radius;
+    return ::selectLod(m_lodErrors.data(), (uint32_t)m_lodErrors.size(), distance,
+                       projectionScale * scale, maxPixelError);
+}
+
+void Model::enqueue(RenderQueue& queue, uint64_t key, const MeshBuffer& meshes, unsigned int vao,
+                    GLsizei instanceCount, uint32_t lod) const
+{
+    for (const DrawItem& item : m_items) {
+        const MeshRange& range = item.levels[std::min<size_t>(lod, item.levels.size() - 1)];
+        queue.submit(withTextureSet(withMaterial(key, item.material), item.textureSet),
+                     makeRenderItem(meshes, vao, range, instanceCount));
+    }
+}
+
+size_t Model::enqueueCulled(RenderQueue& queue, uint64_t key, const MeshBuffer& meshes, MeshletStream& stream,
+                            unsigned int vao, const glm::mat4& transform, const glm::vec3& viewPosition,
+                            const Frustum& frustum)
+{
+    // Cull and stream every sub-mesh first so the element buffer is written
+    // once; it is read when the queue is flushed
+    size_t visible = 0;
+    stream.reset();
+    for (DrawItem& item : m_items) {
+        visible += cullMeshlets(item.meshlets, transform, viewPosition, frustum, m_visibleMeshlets);
+        item.culled = stream.append(item.meshlets, m_visibleMeshlets.data(), m_visibleMeshlets.size());
+    }
+    stream.upload();
+
+    for (const DrawItem& item : m_items) {
+        if (item.culled.indexCount == 0)
+            continue;
+        RenderItem draw = makeRenderItem(meshes, vao, item.levels[0], 1);
+        draw.indexType = GL_UNSIGNED_INT;
+        draw.firstIndex = item.culled.firstIndex;
+        draw.indexCount = item.culled.indexCount;
+        queue.submit(withTextureSet(withMaterial(key, item.material), item.textureSet), draw);
+    }
+    return visible;
+}
+
+size_t Model::meshletCount() const
+{
+    size_t count = 0;
+    for (const DrawItem& item : m_items)
+        count += item.meshlets.meshlets.size();
+    return count;
+}
+
+void Model::release(TextureCache& textures)
+{
+    for (unsigned int texture : m_textures)
+        textures.release(texture);
+    m_textures.clear();
+    m_items.clear();
+    m_lodErrors.clear();
+}
@@ -0,0 +1,121 @@
+/* NormalMatrix.cpp */
+#include "NormalMatrix.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NORMAL_MATRIX_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Relative tolerance for treating a 3x3 as rotation * uniform scale
+    const float RIGID_EPSILON = 1e-4f;
+
+    // Orthogonal columns of equal length: the inverse transpose is the matrix
+    // itself divided by the squared scale
+    bool isRigidUniform(const float* c0, const float* c1, const float* c2, float& scaleSq)
+    {
+        float l0 = c0[0] * c0[0] + c0[1] * c0[1] + c0[2] * c0[2];
+        float l1 = c1[0] * c1[0] + c1[1] * c1[1] + c1[2] * c1[2];
+        float l2 = c2[0] * c2[0] + c2[1] * c2[1] + c2[2] * c2[2];
+        float d01 = c0[0] * c1[0] + c0[1] * c1[1] + c0[2] * c1[2];
+        float d02 = c0[0] * c2[0] + c0[1] * c2[1] + c0[2] * c2[2];
+        float d12 = c1[0] * c2[0] + c1[1] * c2[1] + c1[2] * c2[2];
+        float tolerance = RIGID_EPSILON * l0;
+        scaleSq = l0;
+        return l0 > 0.0f
+            && std::fabs(l1 - l0) <= tolerance && std::fabs(l2 - l0) <= tolerance
+            && std::fabs(d01) <= tolerance && std::fabs(d02) <= tolerance && std::fabs(d12) <= tolerance;
+    }
+
+#ifdef NORMAL_MATRIX_SSE
+    // a.yzx * b.zxy - a.zxy * b.yzx
+    inline __m128 cross(__m128 a, __m128 b)
+    {
+        __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+        return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+    }
+
+    inline float dot3(__m128 a, __m128 b)
+    {
+        __m128 m = _mm_mul_ps(a, b);
+        __m128 y = _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 z = _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 2, 2, 2));
+        return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(m, y), z));
+    }
+
+    void normalMatrix(const glm::mat4& model, glm::mat3& out)
+    {
+        const float* m = &model[0][0];
+        float scaleSq;
+        if (isRigidUniform(m, m + 4, m + 8, scaleSq)) {
+            __m128 inv = _mm_set1_ps(1.0f / scaleSq);
+            alignas(16) float tmp[12];
+            _mm_store_ps(tmp + 0, _mm_mul_ps(_mm_loadu_ps(m + 0), inv));
+            _mm_store_ps(tmp + 4, _mm_mul_ps(_mm_loadu_ps(m + 4), inv));
+            _mm_store_ps(tmp + 8, _mm_mul_ps(_mm_loadu_ps(m + 8), inv));
+            std::memcpy(&out[0][0], tmp + 0, 3 * sizeof(float));
+            std::memcpy(&out[1][0], tmp + 4, 3 * sizeof(float));
+            std::memcpy(&out[2][0], tmp + 8, 3 * sizeof(float));
+            return;
+        }
+
+        // inverse(A)^T = [b x c, c x a, a x b] / det(A) for columns a, b, c
+        __m128 a = _mm_loadu_ps(m + 0);
+        __m128 b = _mm_loadu_ps(m + 4);
+        __m128 c = _mm_loadu_ps(m + 8);
+        __m128 bc = cross(b, c);
+        __m128 ca = cross(c, a);
+        __m128 ab = cross(a, b);
+        float det = dot3(a, bc);
+        __m128 inv = _mm_set1_ps(det != 0.0f ? 1.0f / det : 0.0f);
+
+        alignas(16) float tmp[12];
+        _mm_store_ps(tmp + 0, _mm_mul_ps(bc, inv));
+        _mm_store_ps(tmp + 4, _mm_mul_ps(ca, inv));
+        _mm_store_ps(tmp + 8, _mm_mul_ps(ab, inv));
+        std::memcpy(&out[0][0], tmp + 0, 3 * sizeof(float));
+        std::memcpy(&out[1][0], tmp + 4, 3 * sizeof(float));
+        std::memcpy(&out[2][0], tmp + 8, 3 * sizeof(float));
+    }
+#else
+    void normalMatrix(const glm::mat4& model, glm::mat3& out)
+    {
+        const float* m = &model[0][0];
+        glm::vec3 a(model[0]), b(model[1]), c(model[2]);
+        float scaleSq;
+        if (isRigidUniform(m, m + 4, m + 8, scaleSq)) {
+            float inv = 1.0f / scaleSq;
+            out = glm::mat3(a * inv, b * inv, c * inv);
+            return;
+        }
+        glm::vec3 bc = glm::cross(b, c);
+        float det = glm::dot(a, bc);
+        float inv = det != 0.0f ? 1.0f / det : 0.0f;
+        out = glm::mat3(bc * inv, glm::cross(c, a) * inv, glm::cross(a, b) * inv);
+    }
+#endif
+}
+
+glm::mat3 computeNormalMatrix(const glm::mat4& model)
+{
+    glm::mat3 normal;
+    normalMatrix(model, normal);
+    return normal;
+}
+
+void computeNormalMatrices(const glm::mat4* models, glm::mat3* normals, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        normalMatrix(models[i], normals[i]);
+}
+
+void computeNormalMatrices(InstanceData* instances, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        normalMatrix(instances[i].model, instances[i].normal);
+}
@@ -0,0 +1,222 @@
+/* OcclusionCulling.cpp */
+#include "OcclusionCulling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OCCLUSION_CULLING_SSE 1
+#include <emmintrin.h>
+#endif
+
+OcclusionBuffer::OcclusionBuffer(int width, int height)
+    : m_width((std::max(width, 4) + 3) & ~3), m_height(std::max(height, 1))
+{
+    // Each level halves the previous one, rounding up, down to a single texel
+    glm::ivec2 size(m_width, m_height);
+    for (;;) {
+        m_levelSize.push_back(size);
+        m_levels.emplace_back((size_t)size.x * size.y, 1.0f);
+        if (size.x == 1 && size.y == 1)
+            break;
+        size = glm::ivec2((size.x + 1) / 2, (size.y + 1) / 2);
+    }
+}
+
+void OcclusionBuffer::begin(const glm::mat4& viewProjection)
+{
+    m_viewProjection = viewProjection;
+    std::fill(m_levels[0].begin(), m_levels[0].end(), 1.0f);
+}
+
+void OcclusionBuffer::rasterize(const glm::vec3* positions, const uint32_t* indices, size_t indexCount,
+                                const glm::mat4& transform)
+{
+    const glm::mat4 m = m_viewProjection * transform;
+    for (size_t i = 0; i + 2 < indexCount; i += 3) {
+        glm::vec4 clip[3];
+        for (int k = 0; k < 3; ++k)
+            clip[k] = m * glm::vec4(positions[indices[i + k]], 1.0f);
+
+        // Skip triangles entirely outside one of the clip planes
+        bool outside = false;
+        for (int axis = 0; axis < 3 && !outside; ++axis) {
+            outside = (clip[0][axis] > clip[0].w && clip[1][axis] > clip[1].w && clip[2][axis] > clip[2].w)
+                   || (clip[0][axis] < -clip[0].w && clip[1][axis] < -clip[1].w && clip[2][axis] < -clip[2].w);
+        }
+        if (outside)
+            continue;
+
+        // Clip against the near plane (z >= -w) so every vertex can be divided by w;
+        // a triangle gains at most one vertex
+        glm::vec4 polygon[4];
+        int count = 0;
+        for (int k = 0; k < 3; ++k) {
+            const glm::vec4& cur = clip[k];
+            const glm::vec4& next = clip[(k + 1) % 3];
+            float dCur = cur.z + cur.w, dNext = next.z + next.w;
+            if (dCur >= 0.0f)
+                polygon[count++] = cur;
+            if ((dCur >= 0.0f) != (dNext >= 0.0f))
+                polygon[count++] = cur + (next - cur) * (dCur / (dCur - dNext));
+        }
+
+        glm::vec3 screen[4];
+        bool valid = count >= 3;
+        for (int k = 0; k < count && valid; ++k) {
+            valid = polygon[k].w > 0.0f;
+            float invW = 1.0f / polygon[k].w;
+            screen[k] = glm::vec3((polygon[k].x * invW * 0.5f + 0.5f) * m_width,
+                                  (polygon[k].y * invW * 0.5f + 0.5f) * m_height,
+                                  polygon[k].z * invW * 0.5f + 0.5f);
+        }
+        if (!valid)
+            continue;
+        for (int k = 1; k + 1 < count; ++k)
+            drawTriangle(screen[0], screen[k], screen[k + 1]);
+    }
+}
+
+void OcclusionBuffer::drawTriangle(const glm::vec3& a, const glm::vec3& b0, const glm::vec3& c0)
+{
+    glm::vec3 b = b0, c = c0;
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (!(std::abs(area) > 0.0f))
+        return;
+    // Double-sided: flip clockwise triangles so inside is always positive
+    if (area < 0.0f) {
+        std::swap(b, c);
+        area = -area;
+    }
+
+    // Texels whose centers fall in the triangle's bounding box
+    int minX = std::max(0, (int)std::ceil(std::min(a.x, std::min(b.x, c.x)) - 0.5f));
+    int maxX = std::min(m_width - 1, (int)std::floor(std::max(a.x, std::max(b.x, c.x)) - 0.5f));
+    int minY = std::max(0, (int)std::ceil(std::min(a.y, std::min(b.y, c.y)) - 0.5f));
+    int maxY = std::min(m_height - 1, (int)std::floor(std::max(a.y, std::max(b.y, c.y)) - 0.5f));
+    if (minX > maxX || minY > maxY)
+        return;
+
+    // Edge functions E = A x + B y + C, each non-negative inside and weighting
+    // the opposite vertex; depth is the plane through the three vertices
+    const glm::vec3* from[3] = { &b, &c, &a };
+    const glm::vec3* to[3] = { &c, &a, &b };
+    float A[3], B[3], C[3];
+    for (int e = 0; e < 3; ++e) {
+        A[e] = from[e]->y - to[e]->y;
+        B[e] = to[e]->x - from[e]->x;
+        C[e] = -(A[e] * from[e]->x + B[e] * from[e]->y);
+    }
+    const float invArea = 1.0f / area;
+    const float zx = (A[0] * a.z + A[1] * b.z + A[2] * c.z) * invArea;
+    const float zy = (B[0] * a.z + B[1] * b.z + B[2] * c.z) * invArea;
+    const float zc = (C[0] * a.z + C[1] * b.z + C[2] * c.z) * invArea;
+
+    float* depth = m_levels[0].data();
+    for (int y = minY; y <= maxY; ++y) {
+        const float py = (float)y + 0.5f;
+        float* row = depth + (size_t)y * m_width;
+        int x = minX;
+#ifdef OCCLUSION_CULLING_SSE
+        {
+            // Four texels per step from an aligned start; the width is a
+            // multiple of four so a step never leaves the row
+            x = minX & ~3;
+            const __m128 a0 = _mm_set1_ps(A[0]), a1 = _mm_set1_ps(A[1]), a2 = _mm_set1_ps(A[2]);
+            const __m128 r0 = _mm_set1_ps(B[0] * py + C[0]);
+            const __m128 r1 = _mm_set1_ps(B[1] * py + C[1]);
+            const __m128 r2 = _mm_set1_ps(B[2] * py + C[2]);
+            const __m128 zStep = _mm_set1_ps(zx), zRow = _mm_set1_ps(zy * py + zc);
+            const __m128 lo = _mm_set1_ps((float)minX), hi = _mm_set1_ps((float)maxX + 1.0f);
+            const __m128 zero = _mm_setzero_ps();
+            __m128 px = _mm_add_ps(_mm_set1_ps((float)x + 0.5f), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f));
+            const __m128 four = _mm_set1_ps(4.0f);
+            for (; x <= maxX; x += 4, px = _mm_add_ps(px, four)) {
+                __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), r0);
+                __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), r1);
+                __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), r2);
+                __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                           _mm_and_ps(_mm_cmpge_ps(e2, zero),
+                                                      _mm_and_ps(_mm_cmpge_ps(px, lo), _mm_cmplt_ps(px, hi))));
+                if (_mm_movemask_ps(inside) == 0)
+                    continue;
+                __m128 z = _mm_add_ps(_mm_mul_ps(zStep, px), zRow);
+                __m128 old = _mm_loadu_ps(row + x);
+                __m128 nearer = _mm_min_ps(old, z);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+            }
+        }
+#endif
+        for (; x <= maxX; ++x) {
+            const float px = (float)x + 0.5f;
+            float e0 = A[0] * px + (B[0] * py + C[0]);
+            float e1 = A[1] * px + (B[1] * py + C[1]);
+            float e2 = A[2] * px + (B[2] * py + C[2]);
+            if (e0 < 0.0f || e1 < 0.0f || e2 < 0.0f)
+                continue;
+            row[x] = std::min(row[x], zx * px + (zy * py + zc));
+        }
+    }
+}
+
+void OcclusionBuffer::buildHiZ()
+{
+    // Each texel keeps the farthest depth of the 2x2 texels below it; odd
+    // edges reuse the last row or column
+    for (size_t l = 1; l < m_levels.size(); ++l) {
+        const glm::ivec2 src = m_levelSize[l - 1], dst = m_levelSize[l];
+        const float* in = m_levels[l - 1].data();
+        float* out = m_levels[l].data();
+        for (int y = 0; y < dst.y; ++y) {
+            const float* row0 = in + (size_t)(2 * y) * src.x;
+            const float* row1 = in + (size_t)std::min(2 * y + 1, src.y - 1) * src.x;
+            for (int x = 0; x < dst.x; ++x) {
+                int x0 = 2 * x, x1 = std::min(2 * x + 1, src.x - 1);
+                out[(size_t)y * dst.x + x] = std::max(std::max(row0[x0], row0[x1]), std::max(row1[x0], row1[x1]));
+            }
+        }
+    }
+}
+
+bool OcclusionBuffer::isVisible(const Aabb& bounds) const
+{
+    glm::vec2 ndcMin(1e30f), ndcMax(-1e30f);
+    float nearest = 1e30f;
+    for (int i = 0; i < 8; ++i) {
+        glm::vec3 corner((i & 1) ? bounds.max.x : bounds.min.x,
+                         (i & 2) ? bounds.max.y : bounds.min.y,
+                         (i & 4) ? bounds.max.z : bounds.min.z);
+        glm::vec4 clip = m_viewProjection * glm::vec4(corner, 1.0f);
+        // Boxes reaching behind the eye have no usable screen rectangle
+        if (clip.w <= 1e-6f)
+            return true;
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        ndcMin = glm::min(ndcMin, glm::vec2(ndc));
+        ndcMax = glm::max(ndcMax, glm::vec2(ndc));
+        nearest = std::min(nearest, ndc.z * 0.5f + 0.5f);
+    }
+    if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+        return false;
+
+    int x0 = std::max(0, std::min(m_width - 1, (int)std::floor((ndcMin.x * 0.5f + 0.5f) * m_width)));
+    int x1 = std::max(0, std::min(m_width - 1, (int)std::floor((ndcMax.x * 0.5f + 0.5f) * m_width)));
+    int y0 = std::max(0, std::min(m_height - 1, (int)std::floor((ndcMin.y * 0.5f + 0.5f) * m_height)));
+    int y1 = std::max(0, std::min(m_height - 1, (int)std::floor((ndcMax.y * 0.5f + 0.5f) * m_height)));
+
+    // Coarsest level at which the rectangle spans at most 2x2 texels
+    size_t level = 0;
+    while (level + 1 < m_levels.size()
+           && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+        ++level;
+
+    const glm::ivec2 size = m_levelSize[level];
+    const float* depth = m_levels[level].data();
+    for (int y = y0 >> level; y <= (y1 >> level); ++y) {
+        for (int x = x0 >> level; x <= (x1 >> level); ++x) {
+            if (nearest <= depth[(size_t)y * size.x + x])
+                return true;
+        }
+    }
+    return false;
+}
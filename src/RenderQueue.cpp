@@ -0,0 +1,208 @@
+/* RenderQueue.cpp */
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+namespace {
+    const int PASS_SHIFT = 60;
+    const int SHADER_SHIFT = 52;
+    const int MATERIAL_SHIFT = 40;
+    const int TEXTURE_SET_SHIFT = 28;
+    const int DEPTH_SHIFT = 4;
+
+    const uint64_t PASS_MASK = 0xF;
+    const uint64_t SHADER_MASK = 0xFF;
+    const uint64_t MATERIAL_MASK = 0xFFF;
+    const uint64_t TEXTURE_SET_MASK = 0xFFF;
+    const uint64_t DEPTH_MASK = 0xFFFFFF;
+
+    const uint32_t NO_STATE = 0xFFFFFFFFu;
+
+    inline uint32_t field(uint64_t key, int shift, uint64_t mask)
+    {
+        return (uint32_t)((key >> shift) & mask);
+    }
+}
+
+uint64_t makeSortKey(uint32_t pass, uint32_t shader, uint32_t material, uint32_t textureSet, float depth)
+{
+    uint64_t quantized = (uint64_t)(std::min(std::max(depth, 0.0f), 1.0f) * (float)DEPTH_MASK);
+    return ((pass & PASS_MASK) << PASS_SHIFT)
+         | ((shader & SHADER_MASK) << SHADER_SHIFT)
+         | ((material & MATERIAL_MASK) << MATERIAL_SHIFT)
+         | ((textureSet & TEXTURE_SET_MASK) << TEXTURE_SET_SHIFT)
+         | ((quantized & DEPTH_MASK) << DEPTH_SHIFT);
+}
+
+uint64_t withMaterial(uint64_t key, uint32_t material)
+{
+    return (key & ~(MATERIAL_MASK << MATERIAL_SHIFT)) | ((material & MATERIAL_MASK) << MATERIAL_SHIFT);
+}
+
+uint64_t withTextureSet(uint64_t key, uint32_t textureSet)
+{
+    return (key & ~(TEXTURE_SET_MASK << TEXTURE_SET_SHIFT)) | ((textureSet & TEXTURE_SET_MASK) << TEXTURE_SET_SHIFT);
+}
+
+RenderItem makeRenderItem(const MeshBuffer& meshes, unsigned int vao, const MeshRange& range, GLsizei instanceCount)
+{
+    RenderItem item;
+    item.vao = vao;
+    item.indexType = meshes.indexType();
+    item.firstIndex = range.firstIndex;
+    item.indexCount = range.indexCount;
+    item.baseVertex = range.baseVertex;
+    item.instanceCount = instanceCount;
+    item.decodePositions = meshes.format().quantizedPositions();
+    item.positionOffset = range.positionOffset;
+    item.positionScale = range.positionScale;
+    return item;
+}
+
+//------------------------------------------------------------------------------
+// RenderQueue
+RenderQueue::RenderQueue()
+{
+    m_textureSets.push_back(TextureSet{ { 0, 0 } });
+}
+
+uint32_t RenderQueue::addShader(const Shader& shader)
+{
+    for (uint32_t i = 0; i < (uint32_t)m_shaders.size(); ++i) {
+        if (m_shaders[i].shader == &shader)
+            return i;
+    }
+    m_shaders.push_back(ShaderState{ &shader, shader.uniform("material.shininess"),
+                                     shader.uniform("positionOffset"), shader.uniform("positionScale") });
+    return (uint32_t)m_shaders.size() - 1;
+}
+
+uint32_t RenderQueue::addMaterial(float shininess)
+{
+    m_materials.push_back(shininess);
+    return (uint32_t)m_materials.size() - 1;
+}
+
+uint32_t RenderQueue::addTextureSet(unsigned int diffuse, unsigned int specular)
+{
+    uint64_t pair = (uint64_t)diffuse << 32 | specular;
+    auto it = m_textureSetLookup.find(pair);
+    if (it != m_textureSetLookup.end())
+        return it->second;
+    m_textureSets.push_back(TextureSet{ { diffuse, specular } });
+    uint32_t id = (uint32_t)m_textureSets.size() - 1;
+    m_textureSetLookup.emplace(pair, id);
+    return id;
+}
+
+void RenderQueue::clear()
+{
+    m_items.clear();
+    m_order.clear();
+}
+
+void RenderQueue::submit(uint64_t key, const RenderItem& item)
+{
+    m_order.push_back(SortEntry{ key, (uint32_t)m_items.size() });
+    m_items.push_back(item);
+}
+
+void RenderQueue::sort()
+{
+    const size_t count = m_order.size();
+    if (count < 2)
+        return;
+    m_scratch.resize(count);
+
+    // One counting pass per key byte, least significant first; bytes every
+    // key shares (unused fields, a single pass or shader) are skipped
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t offsets[256] = {};
+        for (const SortEntry& entry : m_order)
+            ++offsets[(entry.key >> shift) & 0xFF];
+        if (offsets[(m_order[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        size_t sum = 0;
+        for (size_t& offset : offsets) {
+            size_t n = offset;
+            offset = sum;
+            sum += n;
+        }
+        for (const SortEntry& entry : m_order)
+            m_scratch[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+        m_order.swap(m_scratch);
+    }
+}
+
+void RenderQueue::flush()
+{
+    m_stats = RenderQueueStats();
+
+    // Start from unknown state; anything may have been bound since last frame
+    uint32_t shader = NO_STATE, material = NO_STATE, textureSet = NO_STATE;
+    unsigned int vao = NO_STATE;
+    unsigned int bound[TEXTURE_SET_UNITS];
+    std::fill(bound, bound + TEXTURE_SET_UNITS, NO_STATE);
+    const RenderItem* lastDecode = nullptr;
+
+    for (const SortEntry& entry : m_order) {
+        const RenderItem& item = m_items[entry.item];
+
+        uint32_t s = field(entry.key, SHADER_SHIFT, SHADER_MASK);
+        if (s != shader) {
+            shader = s;
+            m_shaders[s].shader->use();
+            ++m_stats.shaderChanges;
+            // Uniforms are per program, so material and decode state restart
+            material = NO_STATE;
+            lastDecode = nullptr;
+        }
+        const ShaderState& state = m_shaders[s];
+
+        uint32_t m = field(entry.key, MATERIAL_SHIFT, MATERIAL_MASK);
+        if (m != material) {
+            material = m;
+            if (state.shininess.valid() && m < m_materials.size()) {
+                state.shader->setFloat(state.shininess, m_materials[m]);
+                ++m_stats.materialChanges;
+            }
+        }
+
+        uint32_t t = field(entry.key, TEXTURE_SET_SHIFT, TEXTURE_SET_MASK);
+        if (t != textureSet) {
+            textureSet = t;
+            // Sets sharing a map only rebind the units that differ
+            for (int unit = 0; t != NO_TEXTURES && unit < TEXTURE_SET_UNITS; ++unit) {
+                unsigned int texture = m_textureSets[t].textures[unit];
+                if (bound[unit] == texture)
+                    continue;
+                glActiveTexture(GL_TEXTURE0 + unit);
+                glBindTexture(GL_TEXTURE_2D, texture);
+                bound[unit] = texture;
+                ++m_stats.textureBinds;
+            }
+        }
+
+        if (item.vao != vao) {
+            vao = item.vao;
+            glBindVertexArray(vao);
+            ++m_stats.vertexArrayChanges;
+        }
+
+        if (item.decodePositions
+            && (!lastDecode || lastDecode->positionOffset != item.positionOffset
+                            || lastDecode->positionScale != item.positionScale)) {
+            state.shader->setVec3(state.positionOffset, item.positionOffset);
+            state.shader->setVec3(state.positionScale, item.positionScale);
+            lastDecode = &item;
+        }
+
+        size_t indexSize = item.indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, (GLsizei)item.indexCount, item.indexType,
+                                          (const void*)(item.firstIndex * indexSize), item.instanceCount,
+                                          item.baseVertex);
+        ++m_stats.draws;
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
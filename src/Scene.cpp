@@ -0,0 +1,116 @@
+/* Scene.cpp */
+#include "Scene.h"
+#include "NormalMatrix.h"
+
+Scene::Scene(SpatialIndexType index, float gridCellSize)
+    : m_indexType(index), m_grid(gridCellSize)
+{
+}
+
+Handle Scene::add(const glm::mat4& transform, const Aabb& localBounds)
+{
+    Handle object = m_handles.create();
+    InstanceData instance;
+    instance.model = transform;
+    instance.normal = computeNormalMatrix(transform);
+    m_instances.push_back(instance);
+    m_localBounds.push_back(localBounds);
+    m_worldBounds.push_back(localBounds.transformed(transform));
+
+    if (m_indexType == SpatialIndexType::HashedGrid)
+        m_grid.insert((uint32_t)m_worldBounds.size() - 1, m_worldBounds.back());
+    else
+        m_structureDirty = true;
+    return object;
+}
+
+void Scene::remove(Handle object)
+{
+    if (!m_handles.contains(object))
+        return;
+    uint32_t index = m_handles.destroy(object);
+    uint32_t last = (uint32_t)m_instances.size() - 1;
+    m_instances[index] = m_instances.back();
+    m_localBounds[index] = m_localBounds.back();
+    m_worldBounds[index] = m_worldBounds.back();
+    m_instances.pop_back();
+    m_localBounds.pop_back();
+    m_worldBounds.pop_back();
+
+    if (m_indexType == SpatialIndexType::HashedGrid) {
+        // The grid is keyed by dense index, so the moved element is re-keyed
+        m_grid.remove(index);
+        if (index != last) {
+            m_grid.remove(last);
+            m_grid.insert(index, m_worldBounds[index]);
+        }
+    }
+    else {
+        // Dense indices moved, so the tree's object ids are stale
+        m_structureDirty = true;
+    }
+}
+
+void Scene::setTransform(Handle object, const glm::mat4& transform)
+{
+    if (!m_handles.contains(object))
+        return;
+    uint32_t index = m_handles.indexOf(object);
+    m_instances[index].model = transform;
+    m_instances[index].normal = computeNormalMatrix(transform);
+    m_worldBounds[index] = m_localBounds[index].transformed(transform);
+
+    if (m_indexType == SpatialIndexType::HashedGrid)
+        m_grid.move(index, m_worldBounds[index]);
+    else
+        m_boundsDirty = true;
+}
+
+void Scene::update()
+{
+    if (m_structureDirty) {
+        rebuild();
+    }
+    else if (m_boundsDirty) {
+        m_bvh.refit(m_worldBounds.data());
+        if (m_bvh.sahCost() > m_bvh.builtCost() * m_rebuildThreshold)
+            rebuild();
+    }
+    m_structureDirty = m_boundsDirty = false;
+}
+
+void Scene::rebuild()
+{
+    m_bvh.build(m_worldBounds.data(), m_worldBounds.size());
+    ++m_rebuilds;
+}
+
+void Scene::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& visible) const
+{
+    if (m_indexType == SpatialIndexType::HashedGrid)
+        m_grid.queryFrustum(frustum, visible);
+    else
+        m_bvh.queryFrustum(frustum, visible);
+}
+
+void Scene::querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& objects) const
+{
+    if (m_indexType == SpatialIndexType::HashedGrid)
+        m_grid.querySphere(center, radius, objects);
+    else
+        m_bvh.querySphere(center, radius, objects);
+}
+
+Handle Scene::pick(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float* distance) const
+{
+    uint32_t index;
+    float t;
+    bool hit = m_indexType == SpatialIndexType::HashedGrid
+        ? m_grid.raycast(origin, direction, maxDistance, index, t)
+        : m_bvh.raycast(origin, direction, maxDistance, index, t);
+    if (!hit)
+        return Handle();
+    if (distance)
+        *distance = t;
+    return m_handles.handleAt(index);
+}
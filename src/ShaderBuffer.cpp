@@ -0,0 +1,136 @@
+/* ShaderBuffer.cpp */
+#include "ShaderBuffer.h"
+#include "GLCaps.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // Smallest allocation, so a handful of adds does not reallocate every frame
+    const size_t MIN_CAPACITY = 4096;
+
+    size_t texelSize(GLenum texelFormat)
+    {
+        switch (texelFormat) {
+        case GL_R32F:
+        case GL_R32UI:
+        case GL_R32I:
+            return 4;
+        case GL_RG32F:
+        case GL_RG32UI:
+        case GL_RG32I:
+            return 8;
+        default:
+            return 16;
+        }
+    }
+}
+
+StorageBackend preferredStorageBackend()
+{
+    return GLCaps::get().shaderStorageBuffers ? StorageBackend::ShaderStorage
+                                              : StorageBackend::TextureBuffer;
+}
+
+ShaderOptions shaderOptionsFor(StorageBackend backend)
+{
+    ShaderOptions options;
+    if (backend == StorageBackend::ShaderStorage) {
+        options.version = "430 core";
+        options.defines.push_back("STORAGE_SSBO");
+    }
+    return options;
+}
+
+//------------------------------------------------------------------------------
+// ShaderBuffer
+void ShaderBuffer::create(StorageBackend backend, GLenum texelFormat, unsigned int binding)
+{
+    m_backend = backend;
+    m_texelFormat = texelFormat;
+    m_binding = binding;
+    glGenBuffers(1, &m_buffer);
+    if (m_backend == StorageBackend::TextureBuffer)
+        glGenTextures(1, &m_texture);
+}
+
+size_t ShaderBuffer::maxBytes() const
+{
+    const GLCaps& caps = GLCaps::get();
+    if (m_backend == StorageBackend::ShaderStorage)
+        return (size_t)caps.maxShaderStorageBlockSize;
+    return (size_t)caps.maxTextureBufferSize * texelSize(m_texelFormat);
+}
+
+bool ShaderBuffer::reserve(size_t bytes)
+{
+    // Always allocate once so the binding never points at an empty buffer
+    if (bytes <= m_capacity && m_capacity != 0)
+        return false;
+
+    // Past the limit the buffer would no longer be readable from shaders
+    const size_t limit = maxBytes();
+    if (bytes > limit && !m_limitReported) {
+        std::cout << "ERROR::SHADER_BUFFER::SIZE_LIMIT: " << bytes << " bytes requested, "
+                  << limit << " supported; the excess is dropped" << std::endl;
+        m_limitReported = true;
+    }
+    if (m_capacity != 0 && m_capacity >= limit)
+        return false;
+
+    // Grow geometrically so steadily adding lights stays amortized O(1)
+    size_t capacity = std::max(MIN_CAPACITY, m_capacity);
+    while (capacity < bytes)
+        capacity *= 2;
+    capacity = std::min(capacity, limit);
+
+    glBindBuffer(target(), m_buffer);
+    glBufferData(target(), (GLsizeiptr)capacity, nullptr, GL_DYNAMIC_DRAW);
+    m_capacity = capacity;
+
+    if (m_backend == StorageBackend::TextureBuffer) {
+        glBindTexture(GL_TEXTURE_BUFFER, m_texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, m_texelFormat, m_buffer);
+    }
+    bind();
+    return true;
+}
+
+void ShaderBuffer::update(size_t offset, size_t bytes, const void* data)
+{
+    // Anything past the capacity reserve() could provide is dropped
+    if (offset >= m_capacity)
+        return;
+    bytes = std::min(bytes, m_capacity - offset);
+    glBindBuffer(target(), m_buffer);
+    glBufferSubData(target(), (GLintptr)offset, (GLsizeiptr)bytes, data);
+}
+
+void ShaderBuffer::bind() const
+{
+    if (m_backend == StorageBackend::ShaderStorage) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_binding, m_buffer);
+    }
+    else {
+        glActiveTexture(GL_TEXTURE0 + m_binding);
+        glBindTexture(GL_TEXTURE_BUFFER, m_texture);
+        // Leave unit 0 active so regular 2D texture binds are not redirected
+        glActiveTexture(GL_TEXTURE0);
+    }
+}
+
+void ShaderBuffer::release()
+{
+    if (m_texture != 0)
+        glDeleteTextures(1, &m_texture);
+    if (m_buffer != 0)
+        glDeleteBuffers(1, &m_buffer);
+    m_texture = 0;
+    m_buffer = 0;
+    m_capacity = 0;
+}
+
+GLenum ShaderBuffer::target() const
+{
+    return m_backend == StorageBackend::ShaderStorage ? GL_SHADER_STORAGE_BUFFER : GL_TEXTURE_BUFFER;
+}
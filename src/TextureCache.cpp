@@ -0,0 +1,93 @@
+/* TextureCache.cpp */
+#include "TextureCache.h"
+
+#include <glad/glad.h>
+#include <filesystem>
+#include <system_error>
+
+TextureCache::TextureCache(TextureLoader& loader, size_t maxUnused)
+    : m_loader(loader), m_maxUnused(maxUnused)
+{
+}
+
+std::string TextureCache::makeKey(const std::string& path, const TextureOptions& options)
+{
+    // Different spellings of one file ("a/../b.png", "./b.png") share an entry
+    std::error_code error;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+    if (error)
+        canonical = std::filesystem::absolute(path, error).lexically_normal();
+
+    std::string key = canonical.generic_string();
+    key += options.srgb ? "|srgb" : "|linear";
+    key += options.flipVertically ? "|flip" : "";
+    key += options.normalMap ? "|normal" : "";
+    key += options.compress ? "|bc" : "";
+    key += options.mipFilter == MipFilter::Kaiser ? "|kaiser" : "|box";
+    return key;
+}
+
+unsigned int TextureCache::acquire(const std::string& path, const TextureOptions& options)
+{
+    std::string key = makeKey(path, options);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        Entry entry;
+        entry.texture = m_loader.load(path, options);
+        entry.references = 1;
+        entry.unusedPosition = m_unused.end();
+        m_keyByTexture[entry.texture] = key;
+        m_entries.emplace(key, entry);
+        return entry.texture;
+    }
+
+    Entry& entry = it->second;
+    if (entry.references++ == 0) {
+        m_unused.erase(entry.unusedPosition);
+        entry.unusedPosition = m_unused.end();
+    }
+    return entry.texture;
+}
+
+void TextureCache::release(unsigned int texture)
+{
+    auto keyIt = m_keyByTexture.find(texture);
+    if (keyIt == m_keyByTexture.end())
+        return;
+    Entry& entry = m_entries[keyIt->second];
+    if (entry.references == 0 || --entry.references > 0)
+        return;
+
+    entry.unusedPosition = m_unused.insert(m_unused.begin(), keyIt->second);
+    if (m_unused.size() > m_maxUnused)
+        evictUnused(m_maxUnused);
+}
+
+size_t TextureCache::evictUnused(size_t keep)
+{
+    size_t evicted = 0;
+    auto it = m_unused.end();
+    while (m_unused.size() > keep && it != m_unused.begin()) {
+        --it;
+        auto entryIt = m_entries.find(*it);
+        // A name still waiting for its upload must stay alive for the loader
+        if (m_loader.isPending(entryIt->second.texture))
+            continue;
+
+        glDeleteTextures(1, &entryIt->second.texture);
+        m_keyByTexture.erase(entryIt->second.texture);
+        m_entries.erase(entryIt);
+        it = m_unused.erase(it);
+        ++evicted;
+    }
+    return evicted;
+}
+
+void TextureCache::clear()
+{
+    for (auto& [key, entry] : m_entries)
+        glDeleteTextures(1, &entry.texture);
+    m_entries.clear();
+    m_keyByTexture.clear();
+    m_unused.clear();
+}
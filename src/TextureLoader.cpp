@@ -0,0 +1,325 @@
+/* TextureLoader.cpp */
+#include "TextureLoader.h"
+#include "BlockCompression.h"
+#include "CookedTexture.h"
+#include "GLCaps.h"
+
+#include <glad/glad.h>
+#include <stb_image/stb_image.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+    // The CookedTextureHeader::OPTION_* bits a cooked copy must carry to stand in for a request
+    uint32_t cookedOptions(const TextureOptions& options)
+    {
+        uint32_t bits = 0;
+        bits |= options.srgb ? CookedTextureHeader::OPTION_SRGB : 0;
+        bits |= options.flipVertically ? CookedTextureHeader::OPTION_FLIP : 0;
+        bits |= options.normalMap ? CookedTextureHeader::OPTION_NORMAL_MAP : 0;
+        bits |= options.compress ? CookedTextureHeader::OPTION_COMPRESS : 0;
+        bits |= options.mipFilter == MipFilter::Kaiser ? CookedTextureHeader::OPTION_KAISER : 0;
+        return bits;
+    }
+}
+
+TextureLoader::TextureLoader(unsigned int workerCount, size_t maxDecoded)
+    : m_maxDecoded(std::max<size_t>(maxDecoded, 1))
+{
+    if (workerCount == 0) {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? hardware - 1 : 1;
+    }
+    for (unsigned int i = 0; i < workerCount; ++i)
+        m_workers.emplace_back(&TextureLoader::workerLoop, this);
+}
+
+TextureLoader::~TextureLoader()
+{
+    shutdown();
+}
+
+unsigned int TextureLoader::load(const std::string& path, const TextureOptions& options)
+{
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    // A 1x1 level is a complete mip chain, so the placeholder samples correctly
+    const unsigned char placeholder[4] = { 128, 128, 128, 255 };
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Cooked data is already in its final form; mapping and uploading it is
+    // cheaper than a round trip through the workers. A copy cooked with other
+    // options is simply a different texture; one from an older source is stale.
+    std::string cookedPath = cookedPathFor(path);
+    if (!cookedPath.empty()) {
+        CookedTexture cooked;
+        if (!cooked.open(cookedPath)) {
+            std::cout << "Cooked texture is invalid, decoding source instead: " << cookedPath << std::endl;
+        }
+        else if (cooked.header().options == cookedOptions(options)) {
+            // A missing source leaves the cooked copy as the only data there is
+            uint64_t sourceHash = hashFile(path);
+            if (sourceHash != 0 && sourceHash != cooked.header().sourceHash)
+                std::cout << "Cooked texture is out of date, decoding source instead: " << cookedPath << std::endl;
+            else if (uploadCooked(cooked, texture))
+                return texture;
+            else
+                std::cout << "Cooked texture format is unsupported, decoding source instead: " << cookedPath << std::endl;
+        }
+    }
+
+    // Caps are only readable here on the GL thread; workers get the answer
+    bool compress = false;
+    if (options.compress) {
+        const GLCaps& caps = GLCaps::get();
+        compress = options.normalMap ? caps.textureCompressionRGTC
+                                     : (options.srgb ? caps.textureCompressionS3TCsRGB : caps.textureCompressionS3TC);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.push_back(Request{ path, texture, options, compress });
+        m_pendingTextures.insert(texture);
+        ++m_outstanding;
+    }
+    m_requestReady.notify_one();
+    return texture;
+}
+
+size_t TextureLoader::processUploads(size_t maxUploads)
+{
+    size_t uploaded = 0;
+    while (uploaded < maxUploads) {
+        DecodedImage image;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_decoded.empty())
+                break;
+            image = std::move(m_decoded.front());
+            m_decoded.pop_front();
+        }
+        m_decodedSpace.notify_one();
+
+        upload(image);
+        ++uploaded;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingTextures.erase(image.texture);
+        --m_outstanding;
+    }
+    return uploaded;
+}
+
+void TextureLoader::waitIdle()
+{
+    for (;;) {
+        processUploads();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_outstanding == 0 || m_workers.empty())
+            return;
+        m_decodedReady.wait(lock, [this] { return !m_decoded.empty(); });
+    }
+}
+
+size_t TextureLoader::pending() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_outstanding;
+}
+
+bool TextureLoader::isPending(unsigned int texture) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pendingTextures.count(texture) != 0;
+}
+
+void TextureLoader::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_requestReady.notify_all();
+    m_decodedSpace.notify_all();
+    for (std::thread& worker : m_workers)
+        worker.join();
+    m_workers.clear();
+
+    // Anything still queued keeps its placeholder
+    m_decoded.clear();
+    m_requests.clear();
+    m_pendingTextures.clear();
+    m_outstanding = 0;
+}
+
+std::string TextureLoader::cookedPathFor(const std::string& path) const
+{
+    if (m_cookedDirectory.empty())
+        return std::string();
+    // Mirror the path below the source root, extension included, so equal
+    // stems in other directories or formats never share a cooked file
+    std::filesystem::path relative = std::filesystem::path(path).lexically_normal()
+        .lexically_relative(std::filesystem::path(m_cookedSourceRoot).lexically_normal());
+    if (relative.empty() || *relative.begin() == "..")
+        return std::string();
+    std::filesystem::path cooked = std::filesystem::path(m_cookedDirectory) / relative;
+    cooked += ".tex";
+    std::error_code error;
+    return std::filesystem::is_regular_file(cooked, error) ? cooked.string() : std::string();
+}
+
+bool TextureLoader::uploadCooked(const CookedTexture& cooked, unsigned int texture)
+{
+    const CookedTextureHeader& header = cooked.header();
+    // Without S3TC/RGTC support the uncompressed source is the fallback
+    if (cooked.compressed() && !GLCaps::get().supportsCompressedFormat(header.internalFormat))
+        return false;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    for (uint32_t i = 0; i < header.levelCount; ++i) {
+        const CookedLevelDesc& level = cooked.level(i);
+        if (cooked.compressed())
+            glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)i, header.internalFormat, (GLsizei)level.width,
+                                   (GLsizei)level.height, 0, (GLsizei)level.size, cooked.levelData(i));
+        else
+            glTexImage2D(GL_TEXTURE_2D, (GLint)i, (GLint)header.internalFormat, (GLsizei)level.width,
+                         (GLsizei)level.height, 0, header.format, header.type, cooked.levelData(i));
+    }
+    // The chain may stop early; only sample levels that were provided
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)header.levelCount - 1);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    return true;
+}
+
+void TextureLoader::workerLoop()
+{
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_requestReady.wait(lock, [this] { return m_stopping || !m_requests.empty(); });
+            if (m_stopping)
+                return;
+            request = m_requests.front();
+            m_requests.pop_front();
+        }
+
+        DecodedImage image = decode(request);
+
+        // Back-pressure: hold the pixels until the GL thread has room for them
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_decodedSpace.wait(lock, [this] { return m_stopping || m_decoded.size() < m_maxDecoded; });
+        if (m_stopping)
+            return;
+        m_decoded.push_back(std::move(image));
+        lock.unlock();
+        m_decodedReady.notify_one();
+    }
+}
+
+TextureLoader::DecodedImage TextureLoader::decode(const Request& request)
+{
+    DecodedImage image{ request.path, request.texture, 0, 0, false, {} };
+
+    // Read the whole file first so decoding never waits on disk
+    std::ifstream file(request.path, std::ios::binary);
+    if (!file)
+        return image;
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.empty())
+        return image;
+
+    int width, height, components;
+    if (!stbi_info_from_memory(bytes.data(), (int)bytes.size(), &width, &height, &components))
+        return image;
+    // GL has no grey+alpha format in core, and the block encoder reads RGBA
+    bool compress = request.compress && components != 1;
+    int desired = (components == 2 || compress) ? 4 : 0;
+
+    stbi_set_flip_vertically_on_load_thread(request.options.flipVertically ? 1 : 0);
+    unsigned char* pixels = stbi_load_from_memory(bytes.data(), (int)bytes.size(), &width, &height, &components, desired);
+    if (!pixels)
+        return image;
+    bool hasAlpha = components == 2 || components == 4;
+    if (desired != 0)
+        components = desired;
+
+    const TextureOptions& options = request.options;
+    MipOptions mipOptions;
+    mipOptions.filter = options.mipFilter;
+    mipOptions.srgb = options.srgb;
+    mipOptions.normalMap = options.normalMap;
+    image.levels = generateMipChain(pixels, (uint32_t)width, (uint32_t)height, components, mipOptions);
+    stbi_image_free(pixels);
+
+    if (compress) {
+        BlockFormat blockFormat = BlockFormat::BC1;
+        if (options.normalMap) {
+            blockFormat = BlockFormat::BC5;
+            image.internalFormat = GL_COMPRESSED_RG_RGTC2;
+        }
+        else if (hasAlpha) {
+            blockFormat = BlockFormat::BC3;
+            image.internalFormat = options.srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        }
+        else {
+            image.internalFormat = options.srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        }
+        image.compressed = true;
+
+        // Already on a worker; other workers cover the parallelism
+        for (MipLevel& level : image.levels) {
+            std::vector<uint8_t> blocks(compressedSize(blockFormat, level.width, level.height));
+            compressBlocks(blockFormat, level.data.data(), level.width, level.height, blocks.data(), 1);
+            level.data.swap(blocks);
+        }
+        return image;
+    }
+
+    if (components == 1)
+        image.format = GL_RED;
+    else if (components == 3)
+        image.format = GL_RGB;
+    else
+        image.format = GL_RGBA;
+
+    image.internalFormat = image.format;
+    if (options.srgb && image.format == GL_RGB)
+        image.internalFormat = GL_SRGB8;
+    else if (options.srgb && image.format == GL_RGBA)
+        image.internalFormat = GL_SRGB8_ALPHA8;
+    return image;
+}
+
+void TextureLoader::upload(const DecodedImage& image)
+{
+    if (image.levels.empty()) {
+        std::cout << "Texture failed to load at path: " << image.path << std::endl;
+        return;
+    }
+
+    // Tightly packed rows; RGB and RED widths are not always 4-byte aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindTexture(GL_TEXTURE_2D, image.texture);
+    for (size_t i = 0; i < image.levels.size(); ++i) {
+        const MipLevel& level = image.levels[i];
+        if (image.compressed)
+            glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)i, image.internalFormat, (GLsizei)level.width,
+                                   (GLsizei)level.height, 0, (GLsizei)level.data.size(), level.data.data());
+        else
+            glTexImage2D(GL_TEXTURE_2D, (GLint)i, (GLint)image.internalFormat, (GLsizei)level.width,
+                         (GLsizei)level.height, 0, image.format, GL_UNSIGNED_BYTE, level.data.data());
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)image.levels.size() - 1);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
@@ -1,6 +1,5 @@
 ﻿ #include <glad/glad.h>
  #include <GLFW/glfw3.h>
- #include <stb_image/stb_image.h>
 
  #include <glm/glm.hpp>
  #include <glm/gtc/matrix_transform.hpp>
@@ -8,6 +7,18 @@
  #include "../include/Camera.h"
  #include "../include/Shader.h"
  #include "../include/LightingManager.h"
+ #include "../include/ClusteredLighting.h"
+ #include "../include/InstanceBuffer.h"
+ #include "../include/Lod.h"
+ #include "../include/NormalMatrix.h"
+ #include "../include/OcclusionCulling.h"
+ #include "../include/MeshBuffer.h"
+ #include "../include/Model.h"
+ #include "../include/Primitives.h"
+ #include "../include/RenderQueue.h"
+ #include "../include/Scene.h"
+ #include "../include/TextureCache.h"
+ #include "../include/TextureLoader.h"
 
  #include <iostream>
  #include <random>
@@ -19,7 +30,6 @@
  void mouse_callback(GLFWwindow* window, double xpos, double ypos);
  void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
  void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
- unsigned int loadTexture(const char* path);
 
  // Configuration Constants & Globals
  // ----------------------------------------------------------
@@ -28,12 +38,17 @@
 
  // Camera
  Camera camera (glm::vec3(0.0f, 0.0f, 3.0f));
+ // Current framebuffer size, kept in sync by framebuffer_size_callback
+ int viewportWidth = SCR_WIDTH;
+ int viewportHeight = SCR_HEIGHT;
+
  float lastX = SCR_WIDTH / 2.0f;
  float lastY = SCR_HEIGHT / 2.0f;
  bool firstMouse = true;
  bool rightMouseHeld = false;
  bool middleMouseHeld = false;
  bool resetMousePosition = false;
+ bool pickRequested = false;
 
  // Timing
  float deltaTime = 0.0f;
@@ -59,6 +74,7 @@
      // Callbacks
      glfwMakeContextCurrent(window);
      glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+     glfwGetFramebufferSize(window, &viewportWidth, &viewportHeight);
      glfwSetCursorPosCallback(window, mouse_callback);
      glfwSetMouseButtonCallback(window, mouse_button_callback);
      glfwSetScrollCallback(window, scroll_callback);
@@ -75,7 +91,7 @@
 
      // Create Lighting Manager and add lights
      // --------------------------------------
-     LightingManager lighting;
+     LightingManager lighting;   // stores point lights in an SSBO when supported, a texture buffer otherwise
 
      // Directional light
      DirectionalLightDesc dirDesc;
@@ -102,65 +118,41 @@
      sld.position = camera.Position;
      sld.direction = camera.Front;
      // other fields left at defaults
-     lighting.addSpot(sld);
+     LightHandle cameraSpot = lighting.addSpot(sld);
+
+     // Clustered light culling shares the lighting manager's storage backend
+     ClusteredLighting clusters(lighting.storageBackend());
 
      // Shaders & Textures
      // --------------------------------
-     Shader lightingShader("shaders/lit_geometry.vs", "shaders/lit_geometry.fs");
-     Shader lightingCubeShader("shaders/light_cube.vs", "shaders/light_cube.fs");
+     // Lit shaders are built to match where the lighting manager stores point lights
+     // and how the shared mesh buffer packs its vertices
+     const VertexFormat vertexFormat = VertexFormat::compact();
+     ShaderOptions litOptions = lighting.shaderOptions();
+     addVertexFormatDefines(vertexFormat, litOptions);
+     ShaderOptions cubeOptions;
+     addVertexFormatDefines(vertexFormat, cubeOptions);
+     Shader lightingShader("shaders/lit_geometry.vs", "shaders/lit_geometry.fs", litOptions);
+     Shader lightingCubeShader("shaders/light_cube.vs", "shaders/light_cube.fs", cubeOptions);
+     lighting.bindToShader(lightingShader);
+     clusters.bindToShader(lightingShader);
      lightingShader.use();
      lightingShader.setInt("material.diffuse", 0);
      lightingShader.setInt("material.specular", 1);
-     unsigned int diffuseMap = loadTexture("resources/textures/container2.png");
-     unsigned int specularMap = loadTexture("resources/textures/container2_specular.png");
-
-     // Set up vertex data, buffers, and configure vertex attributes
-     // ------------------------------------------------------------------
-     float vertices[] = {
-         // positions          // normals           // texture coords
-         -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f,  0.0f,
-          0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f,  0.0f,
-          0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f,  1.0f,
-          0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f,  1.0f,
-         -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f,  1.0f,
-         -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f,  0.0f,
-
-         -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
-          0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f,  0.0f,
-          0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f,  1.0f,
-          0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f,  1.0f,
-         -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f,  1.0f,
-         -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
-
-         -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f,  0.0f,
-         -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f,  1.0f,
-         -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f,  1.0f,
-         -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f,  1.0f,
-         -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f,  0.0f,
-         -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f,  0.0f,
-
-          0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f,  0.0f,
-          0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f,  1.0f,
-          0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f,  1.0f,
-          0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f,  1.0f,
-          0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f,  0.0f,
-          0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f,  0.0f,
-
-         -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f,  1.0f,
-          0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f,  1.0f,
-          0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f,  0.0f,
-          0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f,  0.0f,
-         -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f,  0.0f,
-         -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f,  1.0f,
-
-         -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f,  1.0f,
-          0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f,  1.0f,
-          0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f,  0.0f,
-          0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f,  0.0f,
-         -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f,  0.0f,
-         -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f,  1.0f
-     };
-    
+     // Textures decode on worker threads; placeholders are bound until they arrive.
+     // The cache hands out one shared texture per file and decode options.
+     TextureLoader textures;
+     TextureCache textureCache(textures);
+     unsigned int diffuseMap = textureCache.acquire("resources/textures/container2.png");
+     unsigned int specularMap = textureCache.acquire("resources/textures/container2_specular.png");
+
+     // Resolve per-frame uniforms once so the render loop does no name lookups
+     const UniformHandle litViewPos    = lightingShader.uniform("viewPos");
+     const UniformHandle litProjection = lightingShader.uniform("projection");
+     const UniformHandle litView       = lightingShader.uniform("view");
+     const UniformHandle cubeProjection = lightingCubeShader.uniform("projection");
+     const UniformHandle cubeView       = lightingCubeShader.uniform("view");
+
      // world space positions of our cubes
      glm::vec3 cubePositions[] = {
          glm::vec3(0.0f,  0.0f,  0.0f),
@@ -175,35 +167,83 @@
          glm::vec3(-1.3f,  1.0f, -1.5f)
      };
 
-     // Configure cube objects
-     // -------------------------
-     unsigned int VBO, cubeVAO;
-     glGenVertexArrays(1, &cubeVAO);
-     glGenBuffers(1, &VBO);
-     // Bind vertex array object first, then bind and set its vertex and element buffer objects
-     glBindVertexArray(cubeVAO);
-     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-     // Position attribute
-     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-     glEnableVertexAttribArray(0);
-     // Normal attribute
-     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-     glEnableVertexAttribArray(1);
-     // Texture coord attribute
-     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-     glEnableVertexAttribArray(2);
-
-     // Configure light objects
-     // -------------------------
-     unsigned int lightCubeVAO;
-     glGenVertexArrays(1, &lightCubeVAO);
-     glBindVertexArray(lightCubeVAO);
+     // Draws are recorded with sort keys and issued in state order once per
+     // frame; shaders, materials and texture sets are registered up front
+     // (models add their own materials when they load)
+     RenderQueue renderQueue;
+     const uint32_t litShaderId = renderQueue.addShader(lightingShader);
+     const uint32_t lightCubeShaderId = renderQueue.addShader(lightingCubeShader);
+     const uint32_t defaultMaterial = renderQueue.addMaterial(32.0f);
+     const uint32_t containerTextures = renderQueue.addTextureSet(diffuseMap, specularMap);
 
-     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-     // note that we update the lamp's position attribute's stride to reflect the updated buffer data
-     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-     glEnableVertexAttribArray(0);
+     // Configure shared geometry
+     // -------------------------
+     // Every built-in mesh lives in one vertex/index buffer pair behind one VAO,
+     // packed to 16 bytes per vertex
+     MeshBuffer meshes(vertexFormat);
+     const std::vector<Vertex>& cubeVertices = cubeTriangles();
+     const MeshRange cubeMesh = meshes.addDeduplicated(cubeVertices.data(), cubeVertices.size());
+     // Imported models join the same buffer; warm starts read the mesh cache
+     Model backpack;
+     bool hasBackpack = backpack.load("resources/models/backpack/backpack.obj", meshes, textureCache, renderQueue);
+     meshes.upload();
+
+     // The containers live in a scene indexed by a BVH over their world bounds;
+     // each frame only the ones in view are uploaded. They never move, so the
+     // BVH suits them; layers that churn every frame would use the hashed grid.
+     Scene scene(SpatialIndexType::Bvh);
+     Aabb cubeBounds;
+     cubeBounds.grow(glm::vec3(-0.5f));
+     cubeBounds.grow(glm::vec3(0.5f));
+     int cubeCount = 0;
+     for (auto& pos : cubePositions)
+     {
+         // calculate the model matrix for each object
+         glm::mat4 model = glm::mat4(1.0f);
+         model = glm::translate(model, pos);
+         float angle = 20.0f * cubeCount;
+         model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+         scene.add(model, cubeBounds);
+         cubeCount++;
+     }
+     InstanceBuffer cubeInstances;
+     cubeInstances.create();
+     cubeInstances.attachTo(meshes.vao());
+     std::vector<uint32_t> visibleCubes;
+     std::vector<InstanceData> visibleCubeData;
+
+     // The containers double as occluders: their cube is rasterized into a
+     // small CPU depth buffer that everything else is tested against
+     std::vector<glm::vec3> occluderPositions;
+     std::vector<uint32_t> occluderIndices;
+     for (const Vertex& v : cubeVertices)
+     {
+         occluderIndices.push_back((uint32_t)occluderPositions.size());
+         occluderPositions.push_back(v.position);
+     }
+     OcclusionBuffer occlusion;
+
+     // The backpack gets its own VAO over the shared storage for its instance stream,
+     // plus one whose element buffer is the per-frame stream of visible meshlets
+     unsigned int modelVAO = 0;
+     unsigned int meshletVAO = 0;
+     InstanceBuffer modelInstances;
+     MeshletStream backpackMeshlets;
+     const glm::mat4 backpackTransform = glm::translate(glm::mat4(1.0f), glm::vec3(4.0f, 0.0f, -6.0f));
+     if (hasBackpack)
+     {
+         InstanceData instance;
+         instance.model = backpackTransform;
+         instance.normal = computeNormalMatrix(instance.model);
+         modelVAO = meshes.createVertexArray();
+         modelInstances.create();
+         modelInstances.attachTo(modelVAO);
+         modelInstances.upload(&instance, 1);
+         meshletVAO = meshes.createVertexArray();
+         modelInstances.attachTo(meshletVAO);
+         backpackMeshlets.create();
+         backpackMeshlets.attachTo(meshletVAO);
+     }
 
      // Render loop
      // ----------------------------------------------------
@@ -215,57 +255,112 @@
          lastFrame = currentFrame;
          processInput(window);
 
+         // Swap in any textures that finished decoding, a few per frame
+         textures.processUploads(2);
+
          // Clear buffers
          glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
          glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
          // Draw scene geometry with lighting shader
          lightingShader.use();
-         lightingShader.setVec3("viewPos", camera.Position);
-         lightingShader.setFloat("material.shininess", 32.0f);
+         lightingShader.setVec3(litViewPos, camera.Position);
 
-         // Spotlight follows camera each frame
-         //SpotLightDesc sld;
-         //sld.position = camera.Position;
-         //sld.direction = camera.Front;
-         //// override defaults only; no need to re-add the old one
-         //lighting.updateSpot(0, sld);
-
-         // Upload all lights in one shot
-         lighting.uploadToShader(lightingShader);
+         // Spotlight follows camera; only touch it when the camera moved
+         if (sld.position != camera.Position || sld.direction != camera.Front)
+         {
+             sld.position = camera.Position;
+             sld.direction = camera.Front;
+             // override defaults only; no need to re-add the old one
+             lighting.updateSpot(cameraSpot, sld);
+         }
 
          // Set matrices
-         glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
+         float aspect = viewportHeight > 0 ? (float)viewportWidth / (float)viewportHeight : 1.0f;
+         glm::mat4 projection = camera.GetProjectionMatrix(aspect);
          glm::mat4 view = camera.GetViewMatrix();
-         lightingShader.setMat4("projection", projection);
-         lightingShader.setMat4("view", view);
-
-         // Bind textures
-         glActiveTexture(GL_TEXTURE0);
-         glBindTexture(GL_TEXTURE_2D, diffuseMap);
-         glActiveTexture(GL_TEXTURE1);
-         glBindTexture(GL_TEXTURE_2D, specularMap);
-
-         // Draw containers
-         glBindVertexArray(cubeVAO);
-         int cubeCount = 0;
-         for (auto& pos : cubePositions)
+
+         // Cull lights whose influence misses the view, then upload only the
+         // visible lights that changed; every bound shader sees the same buffer
+         const Frustum frustum = camera.GetFrustum(aspect);
+         lighting.cull(frustum);
+         lighting.upload();
+         // Bin point lights into view froxels so fragments only shade nearby lights
+         clusters.update(camera, viewportWidth, viewportHeight, lighting);
+
+         lightingShader.setMat4(litProjection, projection);
+         lightingShader.setMat4(litView, view);
+         lightingCubeShader.use();
+         lightingCubeShader.setMat4(cubeProjection, projection);
+         lightingCubeShader.setMat4(cubeView, view);
+
+         // Left click picks the nearest container under the cursor
+         if (pickRequested)
          {
-             // calculate the model matrix for each object and pass it to shader before drawing
-             glm::mat4 model = glm::mat4(1.0f);
-             model = glm::translate(model, pos);
-             float angle = 20.0 * cubeCount;
-             model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-             lightingShader.setMat4("model", model);
-             glDrawArrays(GL_TRIANGLES, 0, 36);
-             cubeCount++;
+             pickRequested = false;
+             double xpos, ypos;
+             glfwGetCursorPos(window, &xpos, &ypos);
+             glm::vec4 viewport(0.0f, 0.0f, (float)viewportWidth, (float)viewportHeight);
+             glm::vec3 cursor((float)xpos, (float)viewportHeight - (float)ypos, 1.0f);
+             glm::vec3 target = glm::unProject(cursor, view, projection, viewport);
+             float distance;
+             Handle picked = scene.pick(camera.Position, glm::normalize(target - camera.Position), camera.FarPlane, &distance);
+             if (!picked.isNull())
+                 std::cout << "Picked container " << picked.slot << " at distance " << distance << std::endl;
          }
 
-         // Draw light shapes
-          lightingCubeShader.use();
-          lightingCubeShader.setMat4("projection", projection);
-          lightingCubeShader.setMat4("view", view);
-          lighting.drawShapes(lightingCubeShader);
+         // Record this frame's draws
+         renderQueue.clear();
+
+         // All visible containers go in one instanced draw
+         scene.update();
+         scene.queryFrustum(frustum, visibleCubes);
+
+         // Skip whatever sits fully behind the containers in view
+         occlusion.begin(projection * view);
+         for (uint32_t index : visibleCubes)
+             occlusion.rasterize(occluderPositions.data(), occluderIndices.data(), occluderIndices.size(),
+                                 scene.instance(index).model);
+         occlusion.buildHiZ();
+
+         visibleCubeData.clear();
+         for (uint32_t index : visibleCubes)
+         {
+             if (occlusion.isVisible(scene.worldBounds(index)))
+                 visibleCubeData.push_back(scene.instance(index));
+         }
+         cubeInstances.upload(visibleCubeData);
+         if (cubeInstances.count() > 0)
+         {
+             renderQueue.submit(makeSortKey(RENDER_PASS_OPAQUE, litShaderId, defaultMaterial, containerTextures, 0.0f),
+                                makeRenderItem(meshes, meshes.vao(), cubeMesh, (GLsizei)cubeInstances.count()));
+         }
+
+         bool backpackVisible = hasBackpack
+             && occlusion.isVisible(Aabb(backpack.boundsMin(), backpack.boundsMax()).transformed(backpackTransform));
+         if (backpackVisible)
+         {
+             // Coarsest LOD whose simplification error stays under a pixel; at full
+             // detail only the meshlets in view and facing the camera are drawn
+             float lodScale = lodProjectionScale(glm::radians(camera.Zoom), (float)viewportHeight);
+             uint32_t lod = backpack.selectLod(backpackTransform, camera.Position, lodScale);
+             // Sub-meshes fill in their own materials and texture sets
+             float depth = glm::length(glm::vec3(backpackTransform[3]) - camera.Position) / camera.FarPlane;
+             uint64_t key = makeSortKey(RENDER_PASS_OPAQUE, litShaderId, defaultMaterial, RenderQueue::NO_TEXTURES, depth);
+             if (lod == 0)
+                 backpack.enqueueCulled(renderQueue, key, meshes, backpackMeshlets, meshletVAO, backpackTransform, camera.Position, frustum);
+             else
+                 backpack.enqueue(renderQueue, key, meshes, modelVAO, (GLsizei)modelInstances.count(), lod);
+         }
+
+         // Light shapes
+         lighting.enqueueShapes(renderQueue,
+                                makeSortKey(RENDER_PASS_OPAQUE, lightCubeShaderId, defaultMaterial, RenderQueue::NO_TEXTURES, 0.0f),
+                                meshes, cubeMesh);
+
+         // Issue everything grouped by shader, material and textures
+         renderQueue.sort();
+         renderQueue.flush();
 
          // Swap & Poll
          glfwSwapBuffers(window);
@@ -274,9 +369,20 @@
 
      // Cleanup
      // ------------------------------------
-     glDeleteVertexArrays(1, &cubeVAO);
-     glDeleteVertexArrays(1, &lightCubeVAO);
-     glDeleteBuffers(1, &VBO);
+     cubeInstances.release();
+     if (hasBackpack)
+     {
+         glDeleteVertexArrays(1, &modelVAO);
+         glDeleteVertexArrays(1, &meshletVAO);
+         modelInstances.release();
+         backpackMeshlets.release();
+         backpack.release(textureCache);
+     }
+     lighting.release();
+     clusters.release();
+     meshes.release();
+     textures.shutdown();
+     textureCache.clear();
      glfwTerminate();
      return 0;
  }
@@ -312,6 +418,8 @@
  {
      // Make sure viewport matches new dimensions
      glViewport(0, 0, width, height);
+     viewportWidth = width;
+     viewportHeight = height;
  }
 
  // GLFW: Whenever the mouse moves, this callback is called
@@ -374,6 +482,10 @@
  // --------------------------------------------------
  void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
  {
+     // Left Mouse Button Check
+     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
+         pickRequested = true;
+
      // Right Mouse Button Check
      if (button == GLFW_MOUSE_BUTTON_RIGHT  && action == GLFW_PRESS)
      {
@@ -430,43 +542,4 @@
      {
          camera.ProcessMouseScroll(static_cast<float>(yoffset));
      }
- }
-
- // Utility function for loading a 2D texture from file
- // ---------------------------------------------------
- unsigned int loadTexture(char const* path)
- {
-     unsigned int textureID;
-     glGenTextures(1, &textureID);
-
-     int width, height, nrComponents;
-     unsigned char* data = stbi_load(path, &width, &height, &nrComponents, 0);
-     if (data)
-     {
-         GLenum format = GL_RGB;
-         if (nrComponents == 1)
-             format = GL_RED;
-         else if (nrComponents == 3)
-             format = GL_RGB;
-         else if (nrComponents == 4)
-             format = GL_RGBA;
-
-         glBindTexture(GL_TEXTURE_2D, textureID);
-         glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-         glGenerateMipmap(GL_TEXTURE_2D);
-
-         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-         stbi_image_free(data);
-     }
-     else
-     {
-         std::cout << "Texture failed to load at path: " << path << std::endl;
-         stbi_image_free(data);
-     }
-
-     return textureID;
  }
\ No newline at end of file
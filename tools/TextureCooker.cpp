@@ -0,0 +1,202 @@
+/* TextureCooker.cpp */
+// Offline texture cooker: decodes source images once and writes .tex
+// containers holding the full mip chain in its final GL format.
+//
+//   texture-cooker [--srgb] [--flip] [--compress] [--normal] [--kaiser] <input image> <output.tex>
+//   texture-cooker [--srgb] [--flip] [--compress] [--normal] [--kaiser] <input dir> <output dir>
+//
+// --compress stores RGB as BC1 and RGBA as BC3; --normal stores the X/Y of a
+// tangent-space normal map as BC5. Single-channel images stay R8. Mips use a
+// box filter, or a Kaiser-windowed sinc with --kaiser; --srgb filters in
+// linear space and --normal renormalizes every level. Normal maps hold
+// linear vectors, so --normal cannot be combined with --srgb.
+//
+// Directory mode walks the input tree and mirrors it: <input>/a/b.png becomes
+// <output>/a/b.png.tex, the layout TextureLoader expects below its cooked
+// directory. Each file records the options it was cooked with and a hash of
+// its source, and is only used for requests with the same options.
+#include <glad/glad.h>
+#include <stb_image/stb_image.h>
+
+#include "BlockCompression.h"
+#include "CookedTexture.h"
+#include "GLCaps.h"
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    struct CookOptions {
+        bool srgb = false;
+        bool flip = false;
+        bool compress = false;
+        bool normalMap = false;
+        bool kaiser = false;
+    };
+
+    // --normal always compresses, so it only stands in for compressed requests
+    uint32_t cookedOptions(const CookOptions& options)
+    {
+        uint32_t bits = 0;
+        bits |= options.srgb ? CookedTextureHeader::OPTION_SRGB : 0;
+        bits |= options.flip ? CookedTextureHeader::OPTION_FLIP : 0;
+        bits |= options.normalMap ? CookedTextureHeader::OPTION_NORMAL_MAP : 0;
+        bits |= (options.compress || options.normalMap) ? CookedTextureHeader::OPTION_COMPRESS : 0;
+        bits |= options.kaiser ? CookedTextureHeader::OPTION_KAISER : 0;
+        return bits;
+    }
+
+    bool cookFile(const fs::path& input, const fs::path& output, const CookOptions& options)
+    {
+        stbi_set_flip_vertically_on_load(options.flip ? 1 : 0);
+        int width, height, components;
+        if (!stbi_info(input.string().c_str(), &width, &height, &components)) {
+            std::cout << "Failed to read " << input.string() << std::endl;
+            return false;
+        }
+        // GL has no grey+alpha format in core; widen it to RGBA. The block
+        // encoder always reads RGBA.
+        bool compress = (options.compress || options.normalMap) && components != 1;
+        int desired = (components == 2 || compress) ? 4 : 0;
+        unsigned char* pixels = stbi_load(input.string().c_str(), &width, &height, &components, desired);
+        if (!pixels) {
+            std::cout << "Failed to decode " << input.string() << std::endl;
+            return false;
+        }
+        int sourceComponents = components == 2 ? 4 : components;
+        if (desired != 0)
+            components = desired;
+
+        CookedTextureHeader header{};
+        header.width = (uint32_t)width;
+        header.height = (uint32_t)height;
+        header.type = GL_UNSIGNED_BYTE;
+        header.flags = options.srgb ? CookedTextureHeader::FLAG_SRGB : 0;
+        header.options = cookedOptions(options);
+        header.sourceHash = hashFile(input.string());
+        BlockFormat blockFormat = BlockFormat::BC1;
+        if (compress) {
+            header.type = 0;
+            header.flags |= CookedTextureHeader::FLAG_COMPRESSED;
+            if (options.normalMap) {
+                blockFormat = BlockFormat::BC5;
+                header.internalFormat = GL_COMPRESSED_RG_RGTC2;
+            }
+            else if (sourceComponents == 4) {
+                blockFormat = BlockFormat::BC3;
+                header.internalFormat = options.srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            }
+            else {
+                header.internalFormat = options.srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            }
+        }
+        else if (components == 1) {
+            header.format = GL_RED;
+            header.internalFormat = GL_R8;
+        }
+        else if (components == 3) {
+            header.format = GL_RGB;
+            header.internalFormat = options.srgb ? GL_SRGB8 : GL_RGB8;
+        }
+        else {
+            header.format = GL_RGBA;
+            header.internalFormat = options.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+        }
+
+        MipOptions mipOptions;
+        mipOptions.filter = options.kaiser ? MipFilter::Kaiser : MipFilter::Box;
+        mipOptions.srgb = options.srgb;
+        mipOptions.normalMap = options.normalMap;
+        std::vector<MipLevel> mips = generateMipChain(pixels, header.width, header.height, components, mipOptions);
+        stbi_image_free(pixels);
+
+        std::vector<CookedLevel> levels;
+        for (MipLevel& mip : mips)
+            levels.push_back(CookedLevel{ mip.width, mip.height, std::move(mip.data) });
+
+        if (compress) {
+            for (CookedLevel& level : levels) {
+                std::vector<uint8_t> blocks(compressedSize(blockFormat, level.width, level.height));
+                compressBlocks(blockFormat, level.data.data(), level.width, level.height, blocks.data());
+                level.data.swap(blocks);
+            }
+        }
+
+        if (!writeCookedTexture(output.string(), header, levels)) {
+            std::cout << "Failed to write " << output.string() << std::endl;
+            return false;
+        }
+        std::cout << input.filename().string() << " -> " << output.string()
+                  << " (" << width << "x" << height << ", " << levels.size() << " levels)" << std::endl;
+        return true;
+    }
+
+    bool isSourceImage(const fs::path& path)
+    {
+        std::string ext = path.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".bmp";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    CookOptions options;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--srgb") == 0)
+            options.srgb = true;
+        else if (std::strcmp(argv[i], "--flip") == 0)
+            options.flip = true;
+        else if (std::strcmp(argv[i], "--compress") == 0)
+            options.compress = true;
+        else if (std::strcmp(argv[i], "--normal") == 0)
+            options.normalMap = true;
+        else if (std::strcmp(argv[i], "--kaiser") == 0)
+            options.kaiser = true;
+        else
+            paths.push_back(argv[i]);
+    }
+    if (paths.size() != 2) {
+        std::cout << "usage: texture-cooker [--srgb] [--flip] [--compress] [--normal] [--kaiser] <input image|dir> <output.tex|dir>" << std::endl;
+        return 1;
+    }
+    if (options.normalMap && options.srgb) {
+        std::cout << "--normal and --srgb cannot be combined: normal maps are linear data" << std::endl;
+        return 1;
+    }
+
+    fs::path input = paths[0];
+    fs::path output = paths[1];
+    if (!fs::is_directory(input))
+        return cookFile(input, output, options) ? 0 : 1;
+
+    // Directory mode: <input>/<dir>/<name>.<ext> becomes <output>/<dir>/<name>.<ext>.tex
+    std::error_code error;
+    fs::create_directories(output, error);
+    const fs::path outputRoot = fs::weakly_canonical(output, error);
+    int failures = 0;
+    for (fs::recursive_directory_iterator it(input, error), end; it != end; it.increment(error)) {
+        // The output may live inside the input tree; never cook our own results
+        if (it->is_directory() && fs::weakly_canonical(it->path(), error) == outputRoot) {
+            it.disable_recursion_pending();
+            continue;
+        }
+        if (!it->is_regular_file() || !isSourceImage(it->path()))
+            continue;
+        fs::path target = output / it->path().lexically_relative(input);
+        target += ".tex";
+        fs::create_directories(target.parent_path(), error);
+        if (!cookFile(it->path(), target, options))
+            ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}